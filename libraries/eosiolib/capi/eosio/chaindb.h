@@ -47,6 +47,27 @@ primary_key_t chaindb_data(capi_name code, cursor_t, void* data, int32_t size);
 __attribute__((eosio_wasm_import))
 int32_t chaindb_service(capi_name code, cursor_t, void* data, int32_t size);
 
+/**
+ * Header of a row written by chaindb_fetch(), it is followed by `service_size` bytes
+ * of the packed service info and by `data_size` bytes of the packed object.
+ * Headers are not aligned inside of the buffer.
+ */
+struct chaindb_row_header {
+   primary_key_t pk;
+   int32_t       service_size;
+   int32_t       data_size;
+};
+
+/**
+ * Packs up to `count` rows starting from the current position of the cursor into one buffer
+ * and moves the cursor to the row following the last written one.
+ *
+ * @return The number of written rows, 0 if the cursor is at the end,
+ *         or the negated buffer size required for the first row if it doesn't fit into `size`.
+ */
+__attribute__((eosio_wasm_import))
+int32_t chaindb_fetch(capi_name code, cursor_t, int32_t count, void* data, int32_t size);
+
 __attribute__((eosio_wasm_import))
 primary_key_t chaindb_available_primary_key(capi_name code, scope_t scope, capi_name table);
 
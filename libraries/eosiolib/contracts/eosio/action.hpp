@@ -10,6 +10,7 @@
 #include "../../core/eosio/datastream.hpp"
 #include "../../core/eosio/name.hpp"
 #include "../../core/eosio/ignore.hpp"
+#include "../../core/eosio/bytes_view.hpp"
 #include "../../core/eosio/time.hpp"
 
 #include <boost/preprocessor/variadic/size.hpp>
@@ -17,6 +18,14 @@
 #include <boost/preprocessor/tuple/enum.hpp>
 #include <boost/preprocessor/facilities/overload.hpp>
 
+/**
+ * The size of the action-data arena reserved in the static memory, larger action data is read into
+ * a heap buffer, which is kept for the following actions
+ */
+#ifndef EOSIO_ACTION_DATA_RESERVE
+#define EOSIO_ACTION_DATA_RESERVE 8192
+#endif
+
 namespace eosio {
 
    namespace internal_use_do_not_use {
@@ -60,8 +69,42 @@ namespace eosio {
          __attribute__((eosio_wasm_import))
          uint64_t current_receiver();
       }
+
+      alignas(16) inline char action_data_reserve[EOSIO_ACTION_DATA_RESERVE];
+      inline char*  action_data_buffer   = action_data_reserve;
+      inline size_t action_data_capacity = sizeof(action_data_reserve);
+
+      inline char* reserve_action_data( size_t size ) {
+         if( size > action_data_capacity ) {
+            // the old buffer stays in use if the allocation fails
+            char* buffer = (char*)malloc( size );
+            eosio::check( buffer != nullptr, "unable to allocate memory for the action data" );
+            if( action_data_buffer != action_data_reserve )
+               free( action_data_buffer );
+            action_data_buffer   = buffer;
+            action_data_capacity = size;
+         }
+         return action_data_buffer;
+      }
    };
 
+   /**
+    *  Read the action data into the action-data arena shared by the dispatchers and unpack_action_data().
+    *  Nothing is allocated if the data fits into the EOSIO_ACTION_DATA_RESERVE bytes of the static memory.
+    *
+    *  @ingroup action
+    *  @return bytes_view - The action data, it is valid until the action data is read again
+    *  @note The handler of an action can unpack its data straight from the view without a copy,
+    *  e.g. the items of a large batch one by one with datastream<const char*>
+    */
+   inline bytes_view get_action_data() {
+      size_t size = internal_use_do_not_use::action_data_size();
+      char* buffer = internal_use_do_not_use::reserve_action_data( size );
+      if( size > 0 )
+         internal_use_do_not_use::read_action_data( buffer, size );
+      return bytes_view( buffer, size );
+   }
+
    /**
     *  @defgroup action Action
     *  @ingroup contracts
@@ -88,11 +131,8 @@ namespace eosio {
     */
    template<typename T>
    T unpack_action_data() {
-      constexpr size_t max_stack_buffer_size = 512;
-      size_t size = internal_use_do_not_use::action_data_size();
-      char* buffer = (char*)( max_stack_buffer_size < size ? malloc(size) : alloca(size) );
-      internal_use_do_not_use::read_action_data( buffer, size );
-      return unpack<T>( buffer, size );
+      auto data = get_action_data();
+      return unpack<T>( data.data(), data.size() );
    }
 
    /**
@@ -61,21 +61,16 @@ namespace eosio {
     * @param code - The contract object that has the correponding action handler
     * @param func - The action handler
     * @return true
+    * @note The action data is read into the action-data arena (see get_action_data()), which is kept after
+    * the action handler returns, so arguments of std::string_view and eosio::bytes_view types are unpacked
+    * without copies and point into it.
     */
    template<typename T, typename... Args>
    bool execute_action( name self, name code, void (T::*func)(Args...)  ) {
-      size_t size = action_data_size();
-
-      //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
-      constexpr size_t max_stack_buffer_size = 512;
-      void* buffer = nullptr;
-      if( size > 0 ) {
-         buffer = max_stack_buffer_size < size ? malloc(size) : alloca(size);
-         read_action_data( buffer, size );
-      }
+      auto data = get_action_data();
 
       std::tuple<std::decay_t<Args>...> args;
-      datastream<const char*> ds((char*)buffer, size);
+      datastream<const char*> ds(data.data(), data.size());
       ds >> args;
 
       T inst(self, code, ds);
@@ -85,12 +80,43 @@ namespace eosio {
       };
 
       boost::mp11::tuple_apply( f2, args );
-      if ( max_stack_buffer_size < size ) {
-         free(buffer);
-      }
       return true;
    }
 
+   /**
+    * @brief An entry of the dispatch tables of the apply generated by codegen with `-fdispatch-table`
+    *
+    * @ingroup dispatcher
+    */
+   struct dispatch_entry {
+      uint64_t code;   ///< The account of the notification, 0 for the actions and the "*" notify handlers
+      uint64_t action;
+      void (*handler)(unsigned long long receiver, unsigned long long code);
+   };
+
+   /**
+    * @brief Finds the entry of the action in the table sorted by code and action
+    *
+    * @ingroup dispatcher
+    * @param table - The entries sorted by (code, action)
+    * @param size - The number of the entries
+    * @param code - The code of the entry, 0 for an action
+    * @param action - The name of the action
+    * @return The entry, or nullptr if the table has no such entry
+    */
+   inline const dispatch_entry* find_dispatch_entry( const dispatch_entry* table, size_t size, uint64_t code, uint64_t action ) {
+      // the last entry not greater than the key, the loop runs log2(size) times for any key
+      const dispatch_entry* first = table;
+      while( size > 1 ) {
+         size_t half = size / 2;
+         const dispatch_entry* mid = first + half;
+         if( mid->code < code || (mid->code == code && mid->action <= action) )
+            first = mid;
+         size -= half;
+      }
+      return size == 1 && first->code == code && first->action == action ? first : nullptr;
+   }
+
   /// @cond INTERNAL
 
  // Helper macro for EOSIO_DISPATCH_INTERNAL
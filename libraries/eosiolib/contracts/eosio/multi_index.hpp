@@ -4,7 +4,10 @@
 #include "../../core/eosio/name.hpp"
 #include "../../core/eosio/serialize.hpp"
 #include "../../core/eosio/fixed_bytes.hpp"
+#include "../../core/eosio/symbol.hpp"
+#include "../../core/eosio/time.hpp"
 
+#include <array>
 #include <vector>
 #include <tuple>
 #include <boost/hana.hpp>
@@ -15,6 +18,7 @@
 #include <limits>
 #include <algorithm>
 #include <optional>
+#include <deque>
 #include <memory>
 
 #define chaindb_assert(_EXPR, ...) eosio::check(_EXPR, __VA_ARGS__)
@@ -72,6 +76,8 @@ namespace internal_use_do_not_use {
       primary_key_t chaindb_data(account_name_t, cursor_t, void* data, int32_t size);
       __attribute__((eosio_wasm_import))
       int32_t chaindb_service(account_name_t, cursor_t, void* data, int32_t size);
+      __attribute__((eosio_wasm_import))
+      int32_t chaindb_fetch(account_name_t, cursor_t, int32_t count, void* data, int32_t size);
 
       __attribute__((eosio_wasm_import))
       primary_key_t chaindb_available_primary_key(account_name_t, scope_t, table_name_t);
@@ -240,7 +246,7 @@ public:
         if (this == &rhs) {
             return *this;
         }
-        px = rhs.detach();
+        this_type(std::move(rhs)).swap(*this);
         return *this;
     }
 
@@ -319,6 +325,20 @@ namespace _detail {
     template<int I> struct converter_helper<I, I> {
         template<typename... L> void operator()(L&&...) const { }
     }; // struct converter_helper
+
+#ifdef EOSIO_NATIVE
+    // The object caches live for the whole process, the native tester drops them with the rows of its chaindb
+    inline std::vector<void(*)()>& cache_resets() {
+        static std::vector<void(*)()> resets;
+        return resets;
+    }
+
+    inline void reset_caches() {
+        for (auto reset: cache_resets()) {
+            reset();
+        }
+    }
+#endif // EOSIO_NATIVE
 } // namespace _detail
 
 template<typename Key>
@@ -371,12 +391,273 @@ struct key_converter<std::tuple<Indices...>> {
     }
 }; // struct key_converter
 
+namespace _detail {
+    constexpr uint64_t hash_mix(uint64_t value) {
+        // Fibonacci hashing: names and scopes usually have zero low bits,
+        //   so the multiplication spreads the entropy to the high bits
+        return value * 0x9E3779B97F4A7C15ULL;
+    }
+
+    struct uint64_hash {
+        constexpr uint64_t operator()(const uint64_t value) const {
+            return hash_mix(value);
+        }
+    }; // struct uint64_hash
+
+#ifdef EOSIO_NATIVE
+    // The native tests check the lengths of the probe sequences with these counters
+    struct hash_stats {
+        uint64_t lookups = 0; // searches of a key by find, insert and erase
+        uint64_t probes  = 0; // slots compared with the searched keys
+    }; // struct hash_stats
+#endif // EOSIO_NATIVE
+
+    //
+    //  flat_hash_map
+    //
+    //  An open-addressing hash table with linear probing and backward-shift deletion.
+    //  Slots are stored in one contiguous vector with a power-of-two capacity,
+    //  the table index is taken from the high bits of the mixed hash value.
+    //
+    //  Pointers and references to values are invalidated on insert.
+    //
+    template<typename Key, typename Value, typename Hash, typename KeyEqual = std::equal_to<Key>>
+    class flat_hash_map {
+    private:
+        struct slot {
+            Key   key;
+            Value value;
+            bool  used = false;
+        }; // struct slot
+
+        std::vector<slot> slots_;
+        size_t size_  = 0;
+        int    shift_ = 64;
+#ifdef EOSIO_NATIVE
+        mutable hash_stats stats_;
+#endif // EOSIO_NATIVE
+
+        constexpr static size_t min_capacity = 8;
+
+        size_t index_of(const Key& key) const {
+            return static_cast<size_t>(Hash()(key) >> shift_);
+        }
+
+        size_t next_index(const size_t idx) const {
+            return (idx + 1) & (slots_.size() - 1);
+        }
+
+        size_t find_index(const Key& key) const {
+#ifdef EOSIO_NATIVE
+            ++stats_.lookups;
+#endif // EOSIO_NATIVE
+            if (!size_) {
+                return slots_.size();
+            }
+
+            for (auto idx = index_of(key); slots_[idx].used; idx = next_index(idx)) {
+#ifdef EOSIO_NATIVE
+                ++stats_.probes;
+#endif // EOSIO_NATIVE
+                if (KeyEqual()(slots_[idx].key, key)) {
+                    return idx;
+                }
+            }
+            return slots_.size();
+        }
+
+        void rehash(const size_t capacity) {
+            auto old_slots = std::move(slots_);
+
+            slots_ = std::vector<slot>(capacity);
+            size_  = 0;
+            shift_ = 64;
+            for (auto cap = capacity; cap > 1; cap >>= 1) {
+                --shift_;
+            }
+
+            for (auto& old: old_slots) {
+                if (old.used) {
+                    emplace_new(std::move(old.key), std::move(old.value));
+                }
+            }
+        }
+
+        Value& emplace_new(Key key, Value value) {
+            auto idx = index_of(key);
+            while (slots_[idx].used) {
+                idx = next_index(idx);
+            }
+
+            auto& dst = slots_[idx];
+            dst.key   = std::move(key);
+            dst.value = std::move(value);
+            dst.used  = true;
+            ++size_;
+            return dst.value;
+        }
+
+    public:
+        size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return !size_;
+        }
+
+        Value* find(const Key& key) {
+            auto idx = find_index(key);
+            if (idx == slots_.size()) {
+                return nullptr;
+            }
+            return &slots_[idx].value;
+        }
+
+        const Value* find(const Key& key) const {
+            return const_cast<flat_hash_map*>(this)->find(key);
+        }
+
+        Value& insert(Key key, Value value) {
+            auto ptr = find(key);
+            if (ptr) {
+                *ptr = std::move(value);
+                return *ptr;
+            }
+
+            // keep the load factor under 3/4
+            if ((size_ + 1) * 4 > slots_.size() * 3) {
+                rehash(std::max(min_capacity, slots_.size() * 2));
+            }
+            return emplace_new(std::move(key), std::move(value));
+        }
+
+        bool erase(const Key& key) {
+            auto idx = find_index(key);
+            if (idx == slots_.size()) {
+                return false;
+            }
+
+            // backward-shift deletion: no tombstones, so lookups never slow down after erase
+            for (auto next = next_index(idx); slots_[next].used; next = next_index(next)) {
+                auto home = index_of(slots_[next].key);
+                bool in_place = (idx <= next)
+                    ? (idx < home && home <= next)
+                    : (idx < home || home <= next);
+                if (in_place) {
+                    continue;
+                }
+
+                slots_[idx].key   = std::move(slots_[next].key);
+                slots_[idx].value = std::move(slots_[next].value);
+                idx = next;
+            }
+
+            slots_[idx].key   = Key();
+            slots_[idx].value = Value();
+            slots_[idx].used  = false;
+            --size_;
+            return true;
+        }
+
+        template<typename Lambda>
+        void for_each(Lambda&& callback) {
+            for (auto& itm: slots_) {
+                if (itm.used) {
+                    callback(itm.key, itm.value);
+                }
+            }
+        }
+
+        void clear() {
+            for (auto& itm: slots_) {
+                itm = slot();
+            }
+            size_ = 0;
+        }
+
+#ifdef EOSIO_NATIVE
+        const hash_stats& stats() const {
+            return stats_;
+        }
+#endif // EOSIO_NATIVE
+    }; // class flat_hash_map
+
+    struct pool_stats {
+        uint64_t hits   = 0; // allocations served by the pool without calling malloc
+        uint64_t misses = 0; // allocations which required a new slab from the heap
+        uint64_t in_use = 0; // allocated and not yet released slots
+    }; // struct pool_stats
+
+    // Pool of fixed-size slots: released slots are reused, slabs are kept until the end of the action
+    template<size_t Size, size_t Align>
+    class object_pool final {
+        union slot {
+            slot* next;
+            alignas(Align) char data[Size];
+        }; // union slot
+
+        constexpr static size_t min_slab_slots = 8;
+        constexpr static size_t max_slab_slots = 256;
+
+        slot* free_ = nullptr;
+        slot* slab_ = nullptr;
+        size_t slab_used_ = 0;
+        size_t slab_slots_ = 0;
+        pool_stats stats_;
+
+    public:
+        object_pool() = default;
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+        void* allocate() {
+            ++stats_.in_use;
+            if (free_) {
+                ++stats_.hits;
+                auto ptr = free_;
+                free_ = ptr->next;
+                return ptr;
+            }
+
+            if (slab_used_ == slab_slots_) {
+                ++stats_.misses;
+                slab_slots_ = slab_slots_ ? std::min(slab_slots_ * 2, max_slab_slots) : min_slab_slots;
+                slab_ = static_cast<slot*>(malloc(slab_slots_ * sizeof(slot)));
+                chaindb_assert(slab_ != nullptr, "unable to allocate memory");
+                slab_used_ = 0;
+            } else {
+                ++stats_.hits;
+            }
+            return &slab_[slab_used_++];
+        }
+
+        void deallocate(void* ptr) {
+            --stats_.in_use;
+            auto slt = static_cast<slot*>(ptr);
+            slt->next = free_;
+            free_ = slt;
+        }
+
+        const pool_stats& stats() const {
+            return stats_;
+        }
+    }; // class object_pool
+} // namespace _detail
+
 struct service_info {
     eosio::name payer;
     int  size   = 0;
     bool in_ram = false;
 }; // struct service_info
 
+// Layout of the row header written by chaindb_fetch (see capi/eosio/chaindb.h)
+struct fetched_row_header {
+    primary_key_t pk = end_primary_key;
+    int32_t service_size = 0;
+    int32_t data_size = 0;
+}; // struct fetched_row_header
+
 template<typename T, typename MultiIndex>
 struct multi_index_item: public T {
     template<typename Constructor>
@@ -386,11 +667,28 @@ struct multi_index_item: public T {
         constructor(*this);
     }
 
+    // Items of a table are allocated from its own pool instead of the heap
+    static void* operator new(const size_t size) {
+        chaindb_assert(size == sizeof(multi_index_item), "invalid size of multi_index item");
+        return pool().allocate();
+    }
+
+    static void operator delete(void* ptr) {
+        pool().deallocate(ptr);
+    }
+
+    static auto& pool() {
+        static _detail::object_pool<sizeof(multi_index_item), alignof(multi_index_item)> pool;
+        return pool;
+    }
+
     const account_name_t code_;
     const scope_t scope_ = 0;
     service_info  service_;
 
     bool deleted_ = false;
+    bool dirty_ = false;
+    account_name_t dirty_payer_{};
     int ref_cnt_ = 0;
 }; // struct multi_index_item
 
@@ -453,12 +751,63 @@ void safe_allocate(const Size size, const char* error_msg, Lambda&& callback) {
     callback(alloc.data, alloc.size);
 }
 
+namespace _detail {
+    // Size of a packed value if it is known at compile time, 0 for variable-length types
+    template<typename T, typename = void> struct fixed_pack_size
+        : std::integral_constant<size_t, 0> {};
+
+    template<typename T> struct fixed_pack_size<T, std::enable_if_t<std::is_arithmetic<T>::value || std::is_enum<T>::value>>
+        : std::integral_constant<size_t, sizeof(T)> {};
+
+    template<> struct fixed_pack_size<bool>: std::integral_constant<size_t, sizeof(uint8_t)> {};
+    template<> struct fixed_pack_size<name>: std::integral_constant<size_t, sizeof(uint64_t)> {};
+    template<> struct fixed_pack_size<symbol_code>: std::integral_constant<size_t, sizeof(uint64_t)> {};
+    template<> struct fixed_pack_size<symbol>: std::integral_constant<size_t, sizeof(uint64_t)> {};
+    template<> struct fixed_pack_size<microseconds>: std::integral_constant<size_t, sizeof(int64_t)> {};
+    template<> struct fixed_pack_size<time_point>: std::integral_constant<size_t, sizeof(int64_t)> {};
+    template<> struct fixed_pack_size<time_point_sec>: std::integral_constant<size_t, sizeof(uint32_t)> {};
+    template<> struct fixed_pack_size<block_timestamp>: std::integral_constant<size_t, sizeof(uint32_t)> {};
+
+    template<size_t Size> struct fixed_pack_size<fixed_bytes<Size>>
+        : std::integral_constant<size_t, Size> {};
+
+    template<typename T, size_t N> struct fixed_pack_size<std::array<T, N>>
+        : std::integral_constant<size_t, N * fixed_pack_size<T>::value> {};
+
+    // A composite key has a fixed size only if all its fields have it
+    template<typename... Ts> struct fixed_pack_size_all
+        : std::integral_constant<size_t, ((fixed_pack_size<Ts>::value > 0) && ...) ? (fixed_pack_size<Ts>::value + ... + 0) : 0> {};
+
+    template<typename... Ts> struct fixed_pack_size<std::tuple<Ts...>>: fixed_pack_size_all<Ts...> {};
+    template<typename T1, typename T2> struct fixed_pack_size<std::pair<T1, T2>>: fixed_pack_size_all<T1, T2> {};
+} // namespace _detail
+
+/**
+ * Packs the key of an index and passes the packed data to the callback.
+ * Keys with a compile-time known size are packed into a buffer on the stack without calling pack_size(),
+ * other keys are packed into a buffer from safe_allocate().
+ */
+template<typename Key, typename Lambda>
+void pack_key(const Key& key, const char* error_msg, Lambda&& callback) {
+    constexpr auto fixed_size = _detail::fixed_pack_size<std::decay_t<Key>>::value;
+
+    if constexpr (fixed_size > 0) {
+        std::array<char, fixed_size> data;
+        pack_object(key, data.data(), data.size());
+        callback(data.data(), data.size());
+    } else {
+        safe_allocate(pack_size(key), error_msg, [&](auto& data, auto& size) {
+            pack_object(key, data, size);
+            callback(data, size);
+        });
+    }
+}
+
 template<eosio::name::raw TableName, eosio::name::raw IndexName> struct lower_bound final {
     template<typename Key>
     cursor_t operator()(account_name_t code, scope_t scope, const Key& key) const {
         cursor_t cursor;
-        safe_allocate(pack_size(key), "Invalid size of key on lower_bound", [&](auto& data, auto& size) {
-            pack_object(key, data, size);
+        pack_key(key, "Invalid size of key on lower_bound", [&](auto data, auto size) {
             cursor = internal_use_do_not_use::chaindb_lower_bound(code, scope, TableName, IndexName, data, size);
         });
         return cursor;
@@ -475,8 +824,7 @@ template<eosio::name::raw TableName, eosio::name::raw IndexName> struct upper_bo
     template<typename Key>
     cursor_t operator()(account_name_t code, scope_t scope, const Key& key) const {
         cursor_t cursor;
-        safe_allocate(pack_size(key), "Invalid size of key on upper_bound", [&](auto& data, auto& size) {
-            pack_object(key, data, size);
+        pack_key(key, "Invalid size of key on upper_bound", [&](auto data, auto size) {
             cursor = internal_use_do_not_use::chaindb_upper_bound(code, scope, TableName, IndexName, data, size);
         });
         return cursor;
@@ -540,63 +888,87 @@ private:
     mutable primary_key_t next_primary_key_ = end_primary_key;
 
     struct cache_map_t_ {
-        std::vector<item_ptr> vector;
-        std::map<primary_key_t, item_ptr> map;
+        _detail::flat_hash_map<primary_key_t, item_ptr, _detail::uint64_hash> map;
+        std::vector<item_ptr> dirty;
+        bool write_back = false;
 
-        item_ptr find(const primary_key_t pk) {
-            auto mtr = map.find(pk);
-            if (map.end() != mtr) {
-                return mtr->second;
-            }
+        // primary keys erased while ranges are open: the ranges skip their prefetched rows
+        _detail::flat_hash_map<primary_key_t, bool, _detail::uint64_hash> erased;
+        int32_t  open_ranges = 0;
+        uint32_t clears = 0;
 
-            auto vtr = std::find_if(vector.rbegin(), vector.rend(), [&pk](const auto& itm) {
-                return primary_key_extractor_type()(*itm) == pk;
-            });
-            if (vector.rend() != vtr) {
-                return (*vtr);
+        item_ptr find(const primary_key_t pk) {
+            auto ptr = map.find(pk);
+            if (ptr) {
+                return *ptr;
             }
             return item_ptr();
         }
 
         void insert(item_ptr ptr) {
-            if (vector.size() >= 8) {
-                map.emplace(primary_key_extractor_type()(*ptr), ptr);
-            } else {
-                vector.push_back(ptr);
+            auto pk = primary_key_extractor_type()(*ptr);
+            if (!erased.empty()) {
+                erased.erase(pk);
             }
+            map.insert(pk, std::move(ptr));
         }
 
         void remove(primary_key_t pk) {
-            auto mtr = map.find(pk);
-            if (map.end() != mtr) {
-                mtr->second->deleted_ = true;
-                map.erase(mtr);
-                return;
+            if (open_ranges) {
+                erased.insert(pk, true);
+            }
+            auto ptr = map.find(pk);
+            if (ptr) {
+                (*ptr)->deleted_ = true;
+                map.erase(pk);
             }
+        }
 
-            auto vtr = std::find_if(vector.rbegin(), vector.rend(), [&pk](const auto& itm) {
-                return primary_key_extractor_type()(*itm) == pk;
-            });
-            if (vector.rend() != vtr) {
-                (*vtr)->deleted_ = true;
-                vector.erase(--(vtr.base()));
+        bool is_erased(primary_key_t pk) const {
+            return !erased.empty() && erased.find(pk);
+        }
+
+        void open_range() {
+            ++open_ranges;
+        }
+
+        void close_range() {
+            if (!--open_ranges) {
+                erased.clear();
             }
         }
 
         void clear() {
-            for (auto& itm_ptr: vector) {
+            map.for_each([](const auto&, auto& itm_ptr) {
                 itm_ptr->deleted_ = true;
-            }
-            vector.clear();
-
-            for (auto& itm: map) {
-                itm.second->deleted_ = true;
-            }
+            });
             map.clear();
+            ++clears;
+        }
+
+        // drops the cached objects without writing the dirty ones, and disables the write-back mode
+        void reset() {
+            dirty.clear();
+            write_back = false;
+            clear();
         }
     }; // struct cache_map_t_
 
-    using cache_vector_t_ = std::vector<item_ptr>;
+    struct cache_key_t_ {
+        account_name_t code;
+        scope_t scope = 0;
+
+        friend bool operator == (const cache_key_t_& a, const cache_key_t_& b) {
+            return a.code == b.code && a.scope == b.scope;
+        }
+    }; // struct cache_key_t_
+
+    struct cache_key_hash_t_ {
+        constexpr uint64_t operator()(const cache_key_t_& key) const {
+            return _detail::hash_mix(_detail::hash_mix(static_cast<uint64_t>(key.code)) ^ key.scope);
+        }
+    }; // struct cache_key_hash_t_
+
     struct cache_item_t_ {
         const account_name_t code;
         const scope_t scope;
@@ -607,13 +979,34 @@ private:
         }
     };
 
+    using cache_index_t_ = _detail::flat_hash_map<cache_key_t_, cache_map_t_*, cache_key_hash_t_>;
+
+    static cache_index_t_& get_cache_index() {
+        static cache_index_t_ cache_index;
+        return cache_index;
+    }
+
     static cache_map_t_& get_items_map(const account_name_t code, const scope_t scope) {
-        static std::deque<cache_item_t_> cache_map;
-        for (auto& itm: cache_map) {
-            if (itm.code == code && itm.scope == scope) return itm.items_map;
+        // the deque keeps the addresses of items stable, the hash table only indexes them
+        static std::deque<cache_item_t_> cache_items;
+        auto& cache_index = get_cache_index();
+#ifdef EOSIO_NATIVE
+        static const bool reset_registered = (_detail::cache_resets().push_back([]() {
+            for (auto& item: cache_items) {
+                item.items_map.reset();
+            }
+        }), true);
+        (void)reset_registered;
+#endif // EOSIO_NATIVE
+
+        const cache_key_t_ key{code, scope};
+        auto ptr = cache_index.find(key);
+        if (ptr) {
+            return *(*ptr);
         }
-        cache_map.push_back({code, scope});
-        return cache_map.back().items_map;
+
+        cache_items.emplace_back(code, scope);
+        return *cache_index.insert(key, &cache_items.back().items_map);
     }
 
     cache_map_t_& items_map_;
@@ -798,12 +1191,14 @@ private:
         }
 
         void lazy_open_begin() const {
+            multidx().template sync_index<IndexName>();
             cursor_ = internal_use_do_not_use::chaindb_begin(code(), scope(), table_name(), index_name());
             chaindb_assert(is_cursor_initialized(), "unable to open begin iterator");
             primary_key_ = internal_use_do_not_use::chaindb_current(code(), cursor_);
         }
 
         void lazy_open_end() const {
+            multidx().template sync_index<IndexName>();
             cursor_ = internal_use_do_not_use::chaindb_end(code(), scope(), table_name(), index_name());
             chaindb_assert(is_cursor_initialized(), "unable to open end iterator");
         }
@@ -945,6 +1340,204 @@ private:
         }
     }; // struct multi_index::const_reverse_iterator_impl
 
+    // Single-pass range over primary keys [lower, upper).
+    // Rows are prefetched in chunks by one chaindb_fetch call and unpacked on dereference.
+    struct const_range_impl {
+    public:
+        struct const_iterator: public std::iterator<std::input_iterator_tag, const T> {
+        public:
+            using pointer   = const T*;
+            using reference = const T&;
+
+            constexpr friend bool operator == (const const_iterator& a, const const_iterator& b) {
+                return a.is_end() == b.is_end();
+            }
+            constexpr friend bool operator != (const const_iterator& a, const const_iterator& b) {
+                return !(operator == (a, b));
+            }
+
+            reference operator*() const {
+                return *this->operator->();
+            }
+            pointer operator->() const {
+                chaindb_assert(!is_end(), "cannot dereference end iterator of range");
+                return static_cast<pointer>(range_->load_object());
+            }
+            primary_key_t pk() const {
+                chaindb_assert(!is_end(), "cannot get primary key from end iterator of range");
+                return range_->header_.pk;
+            }
+
+            const_iterator& operator++() {
+                chaindb_assert(!is_end(), "cannot increment end iterator of range");
+                range_->next();
+                return *this;
+            }
+
+        private:
+            friend const_range_impl;
+
+            constexpr const_iterator() = default;
+            constexpr const_iterator(const const_range_impl* range)
+            : range_(range) {
+            }
+
+            constexpr bool is_end() const {
+                return range_ == nullptr || range_->is_end();
+            }
+
+            const const_range_impl* range_ = nullptr;
+        }; // struct multi_index::const_range_impl::const_iterator
+
+        const_iterator begin() const {
+            lazy_open();
+            return const_iterator(this);
+        }
+
+        const_iterator end() const {
+            return const_iterator();
+        }
+
+        const_range_impl(const const_range_impl&) = delete;
+        const_range_impl& operator=(const const_range_impl&) = delete;
+
+        const_range_impl(const_range_impl&& src)
+        : multidx_(src.multidx_), lower_(src.lower_), upper_(src.upper_), chunk_rows_(src.chunk_rows_),
+          cursor_(src.cursor_), buffer_(std::move(src.buffer_)), pos_(src.pos_), rows_left_(src.rows_left_),
+          header_(src.header_), fetched_clears_(src.fetched_clears_), at_end_(src.at_end_), item_(std::move(src.item_)) {
+            src.cursor_ = uninitialized_state;
+        }
+
+        ~const_range_impl() {
+            if (cursor_ != uninitialized_state) {
+                internal_use_do_not_use::chaindb_close(multidx_->code(), cursor_);
+                multidx_->items_map_.close_range();
+            }
+        }
+
+    private:
+        friend multi_index;
+
+        constexpr static cursor_t uninitialized_state = 0;
+        constexpr static size_t   min_buffer_size = 1024;
+
+        const_range_impl(const multi_index* midx, const primary_key_t lower, const primary_key_t upper, const int32_t chunk_rows)
+        : multidx_(midx), lower_(lower), upper_(upper), chunk_rows_(chunk_rows) {
+            chaindb_assert(chunk_rows_ > 0, "invalid number of rows in chunk");
+        }
+
+        const multi_index* multidx_ = nullptr;
+        const primary_key_t lower_;
+        const primary_key_t upper_;
+        const int32_t chunk_rows_;
+
+        mutable cursor_t cursor_ = uninitialized_state;
+        mutable std::vector<char> buffer_;
+        mutable size_t pos_ = 0;
+        mutable int32_t rows_left_ = 0;
+        mutable fetched_row_header header_;
+        mutable uint32_t fetched_clears_ = 0;
+        mutable bool at_end_ = false;
+        mutable item_ptr item_;
+
+        bool is_end() const {
+            return at_end_;
+        }
+
+        void lazy_open() const {
+            if (cursor_ != uninitialized_state || at_end_) {
+                return;
+            }
+
+            cursor_ = internal_use_do_not_use::chaindb_lower_bound_pk(
+                multidx_->code(), multidx_->scope(), table_name(), lower_);
+            chaindb_assert(cursor_ != uninitialized_state, "unable to open range cursor");
+            multidx_->items_map_.open_range();
+            buffer_.resize(min_buffer_size);
+            fetch_chunk();
+            read_header();
+        }
+
+        void fetch_chunk() const {
+            pos_ = 0;
+            fetched_clears_ = multidx_->items_map_.clears;
+            rows_left_ = internal_use_do_not_use::chaindb_fetch(
+                multidx_->code(), cursor_, chunk_rows_, buffer_.data(), buffer_.size());
+            if (rows_left_ < 0) {
+                // the row doesn't fit into the buffer, the cursor stays on it
+                buffer_.resize(static_cast<size_t>(-rows_left_));
+                rows_left_ = internal_use_do_not_use::chaindb_fetch(
+                    multidx_->code(), cursor_, chunk_rows_, buffer_.data(), buffer_.size());
+                chaindb_assert(rows_left_ >= 0, "invalid size of fetched row");
+            }
+        }
+
+        void read_header() const {
+            item_.reset();
+            for (;;) {
+                if (!rows_left_) {
+                    at_end_ = true;
+                    return;
+                }
+
+                chaindb_assert(pos_ + sizeof(header_) <= buffer_.size(), "invalid fetched row");
+                memcpy(&header_, buffer_.data() + pos_, sizeof(header_));
+                chaindb_assert(header_.service_size >= 0 && header_.data_size > 0, "invalid fetched row");
+                chaindb_assert(pos_ + sizeof(header_) + header_.service_size + header_.data_size <= buffer_.size(),
+                    "invalid fetched row");
+
+                if (header_.pk >= upper_) {
+                    at_end_ = true;
+                    return;
+                }
+                if (!multidx_->items_map_.is_erased(header_.pk)) {
+                    return;
+                }
+                // the row was erased after the chunk had been fetched
+                skip_row();
+            }
+        }
+
+        void skip_row() const {
+            pos_ += sizeof(header_) + header_.service_size + header_.data_size;
+            --rows_left_;
+            if (!rows_left_) {
+                fetch_chunk();
+            }
+        }
+
+        void next() const {
+            skip_row();
+            read_header();
+        }
+
+        const item* load_object() const {
+            if (item_ && !item_->deleted_) {
+                return item_.get();
+            }
+
+            const auto pk = header_.pk;
+            chaindb_assert(!multidx_->items_map_.is_erased(pk), "object was erased");
+            item_ = multidx_->find_object_in_cache(pk);
+            if (item_) {
+                return item_.get();
+            }
+
+            if (fetched_clears_ != multidx_->items_map_.clears) {
+                // the cache was flushed after the fetch, so the prefetched row can be older than the table
+                auto itr = multidx_->find(pk);
+                chaindb_assert(itr != multidx_->cend(), "object was erased");
+                item_ = item_ptr(const_cast<item*>(static_cast<const item*>(&*itr)));
+                return item_.get();
+            }
+
+            auto service = buffer_.data() + pos_ + sizeof(header_);
+            auto data = service + header_.service_size;
+            item_ = multidx_->load_object(pk, data, header_.data_size, service, header_.service_size);
+            return item_.get();
+        }
+    }; // struct multi_index::const_range_impl
+
     template<index_name_t IndexName, typename Extractor>
     struct index {
     public:
@@ -1175,6 +1768,7 @@ private:
         *  @return An iterator pointing to the first object that has the lowest primary key that is greater than or equal to @a key. If no such object is found, a past-the-end iterator is returned.
         */
         const_iterator lower_bound(const key_type& key) const {
+            multidx_->template sync_index<IndexName>();
             eosio::lower_bound<TableName, IndexName> finder;
             auto cursor = finder(code(), scope(), key);
             return const_iterator(multidx_, cursor);
@@ -1200,6 +1794,7 @@ private:
         *  @return An iterator pointing to the first object that is greater than specified by the key value. If no such object is found, a past-the-end iterator is returned.
         */
         const_iterator upper_bound(const key_type& key) const {
+            multidx_->template sync_index<IndexName>();
             eosio::upper_bound<TableName, IndexName> finder;
             auto cursor = finder(code(), scope(), key);
             return const_iterator(multidx_, cursor);
@@ -1217,11 +1812,12 @@ private:
             const auto& itm = static_cast<const item&>(obj);
             chaindb_assert(multidx_->is_same_multidx(itm), "object passed to iterator_to is not in multi_index");
 
+            multidx_->template sync_index<IndexName>();
+
             auto key = extractor_type()(itm);
             auto pk = primary_key_extractor_type()(itm);
             cursor_t cursor;
-            safe_allocate(pack_size(key), "invalid size of key", [&](auto& data, auto& size) {
-                pack_object(key, data, size);
+            pack_key(key, "invalid size of key", [&](auto data, auto size) {
                 cursor = internal_use_do_not_use::chaindb_locate_to(
                     code(), scope(), table_name(), index_name(), pk, data, size);
             });
@@ -1334,15 +1930,9 @@ private:
         safe_allocate(size, "object doesn't exist", [&](auto& data, auto& datasize) {
             auto dpk = internal_use_do_not_use::chaindb_data(code(), cursor, data, datasize);
             chaindb_assert(dpk == pk, "invalid packet object");
-            ptr = item_ptr(new item(*this, [&](auto& itm) {
-                T& obj = static_cast<T&>(itm);
-                unpack_object(obj, data, datasize);
-            }));
+            ptr = make_object(pk, data, datasize);
         });
 
-        auto ptr_pk = primary_key_extractor_type()(*ptr);
-        chaindb_assert(ptr_pk == pk, "invalid primary key of object");
-
         safe_allocate(sizeof(service_info), "object doesn't exist", [&](auto& data, auto& datasize) {
             internal_use_do_not_use::chaindb_service(code(), cursor, data, datasize);
             unpack_object(ptr->service_, data, datasize);
@@ -1352,21 +1942,90 @@ private:
         return std::move(ptr);
     }
 
+    item_ptr load_object(
+        const primary_key_t pk, const char* data, const size_t size, const char* service, const size_t service_size
+    ) const {
+        auto ptr = find_object_in_cache(pk);
+        if (ptr) {
+            return std::move(ptr);
+        }
+
+        ptr = make_object(pk, data, size);
+        unpack_object(ptr->service_, service, service_size);
+
+        add_object_to_cache(ptr);
+        return std::move(ptr);
+    }
+
+    item_ptr make_object(const primary_key_t pk, const char* data, const size_t size) const {
+        auto ptr = item_ptr(new item(*this, [&](auto& itm) {
+            T& obj = static_cast<T&>(itm);
+            unpack_object(obj, data, size);
+        }));
+
+        auto ptr_pk = primary_key_extractor_type()(*ptr);
+        chaindb_assert(ptr_pk == pk, "invalid primary key of object");
+        return ptr;
+    }
+
     constexpr bool is_same_multidx(const item& o) const {
         return (o.code_ == code() && o.scope_ == scope());
     }
 
+    void update_object(item& itm, const account_name_t payer) const {
+        auto pk = primary_key_extractor_type()(itm);
+        const T& obj = static_cast<const T&>(itm);
+
+        safe_allocate(pack_size(obj), "invalid size of object", [&](auto& data, auto& size) {
+            pack_object(obj, data, size);
+            auto delta = internal_use_do_not_use::chaindb_update(code(), scope(), table_name(), payer, pk, data, size);
+            itm.service_.payer = eosio::name(payer);
+            itm.service_.size += delta;
+        });
+    }
+
+    void flush_dirty_objects() const {
+        if (items_map_.dirty.empty()) {
+            return;
+        }
+
+        auto dirty = std::move(items_map_.dirty);
+        items_map_.dirty.clear();
+        for (auto& ptr: dirty) {
+            if (ptr->deleted_ || !ptr->dirty_) {
+                continue;
+            }
+            ptr->dirty_ = false;
+            update_object(*ptr, ptr->dirty_payer_);
+        }
+    }
+
+    template<index_name_t IndexName>
+    void sync_index() const {
+        // Secondary indices are ordered by chaindb, so it should have the last state of objects
+        if (IndexName != "primary"_n) {
+            flush_dirty_objects();
+        }
+    }
+
 public:
     using pointer   = const T*;
     using reference = const T&;
     using const_iterator = const_iterator_impl<"primary"_n>;
     using const_reverse_iterator = const_reverse_iterator_impl<"primary"_n>;
+    using const_range = const_range_impl;
+
+    constexpr static int32_t default_range_chunk_rows = 16;
 
 public:
     multi_index(const account_name_t code, const scope_t scope)
     : code_(code), scope_(scope), primary_idx_(this), items_map_(get_items_map(code, scope)) {
     }
 
+    ~multi_index() {
+        flush_dirty_objects();
+    }
+
     constexpr static table_name_t table_name()       { return TableName; }
     constexpr        account_name_t code()     const { return code_; }
     constexpr        scope_t        scope()    const { return scope_; }
@@ -1391,6 +2050,28 @@ public:
         return primary_idx_.upper_bound(pk);
     }
 
+    /**
+    *  The @ref range method is used to scan objects with primary keys in the range [lower, upper).
+    *  @ingroup multiindex
+    *
+    *  @param lower - the lowest primary key of the range
+    *  @param upper - the primary key following the last one in the range
+    *  @param chunk_rows - number of rows fetched from the chain database by one call
+    *
+    *  @return A single-pass range of objects. Rows are fetched in chunks by one host call
+    *  (instead of next/datasize/data/service calls per row) and unpacked lazily on dereference.
+    *
+    *  @note Rows erased during the scan are skipped, and rows modified during the scan are returned with their
+    *  new values. A row emplaced during the scan is returned only if its primary key is above the last row
+    *  of the already fetched chunk.
+    */
+    const_range range(
+        const primary_key_t lower, const primary_key_t upper = end_primary_key,
+        const int32_t chunk_rows = default_range_chunk_rows
+    ) const {
+        return const_range(this, lower, upper, chunk_rows);
+    }
+
     primary_key_t available_primary_key() const {
         if (next_primary_key_ == end_primary_key) {
             next_primary_key_ = internal_use_do_not_use::chaindb_available_primary_key(code(), scope(), table_name());
@@ -1418,9 +2099,58 @@ public:
     }
 
     void flush_cache() {
+        flush_dirty_objects();
         items_map_.clear();
     }
 
+    /**
+    *  The @ref set_write_back method is used to enable or disable the write-back mode for the table scope.
+    *  @ingroup multiindex
+    *
+    *  @param value - true to enable the write-back mode
+    *
+    *  @details In the write-back mode @ref modify only updates the cached object and marks it as dirty.
+    *  Each dirty object is serialized and written to the table once: on @ref flush_cache,
+    *  before @ref emplace, before @ref erase, before lookups by secondary indices, on moving objects between RAM and archive,
+    *  or on destruction of the multi_index object (usually at the end of the action).
+    *  The payer of the last @ref modify call with a non-empty payer is charged.
+    *
+    *  The mode is shared by all multi_index objects of the same table, code and scope.
+    *  Disabling the mode writes all dirty objects.
+    *
+    *  @warning Dirty objects are written by the destructor of multi_index, so they are lost
+    *  if the action is finished by eosio_exit(). Call @ref flush_cache before eosio_exit() in the write-back mode.
+    */
+    void set_write_back(const bool value) {
+        if (!value) {
+            flush_dirty_objects();
+        }
+        items_map_.write_back = value;
+    }
+
+    bool is_write_back() const {
+        return items_map_.write_back;
+    }
+
+    /**
+    *  Returns counters of the pool which allocates cached objects of the table.
+    *  Misses are allocations of new slabs from the heap, hits are allocations served by the pool.
+    *  @ingroup multiindex
+    */
+    static const _detail::pool_stats& item_pool_stats() {
+        return item::pool().stats();
+    }
+
+#ifdef EOSIO_NATIVE
+    /**
+    *  Returns counters of the index which finds the object cache of a scope of the table on every construction.
+    *  @ingroup multiindex
+    */
+    static const _detail::hash_stats& scope_cache_stats() {
+        return get_cache_index().stats();
+    }
+#endif // EOSIO_NATIVE
+
     /**
     *  The @ref emplace is used to insert a new object (i.e., row) into the table.
     *  @ingroup multiindex
@@ -1452,6 +2182,9 @@ public:
         auto  pk = primary_key_extractor_type()(obj);
         chaindb_assert(pk != end_primary_key, "invalid value of primary key");
 
+        // the pending updates are written first, the new object can take a unique key released by them
+        flush_dirty_objects();
+
         safe_allocate(pack_size(obj), "invalid size of object", [&](auto& data, auto& size) {
             pack_object(obj, data, size);
             auto delta = internal_use_do_not_use::chaindb_insert(code(), scope(), table_name(), payer, pk, data, size);
@@ -1487,6 +2220,7 @@ public:
     *  @post The payer is charged for the storage usage of the updated object.
     *  @post If payer is the same as the existing payer, payer only pays for the usage difference between existing and updated object (and is refunded if this difference is negative).
     *  @post If payer is different from the existing payer, the existing payer is refunded for the storage usage of the existing object.
+    *  @post In the write-back mode (see @ref set_write_back) the object is serialized and written later, once for all modifications.
     *
     *  > @b Exceptions  
     *  > The object to be modified belongs to a table of another contract.  
@@ -1511,12 +2245,18 @@ public:
         auto mpk = primary_key_extractor_type()(obj);
         chaindb_assert(pk == mpk, "updater cannot change primary key when modifying an object");
 
-        safe_allocate(pack_size(obj), "invalid size of object", [&](auto& data, auto& size) {
-            pack_object(obj, data, size);
-            auto delta = internal_use_do_not_use::chaindb_update(code(), scope(), table_name(), payer, pk, data, size);
-            itm.service_.payer = eosio::name(payer);
-            itm.service_.size += delta;
-        });
+        if (!items_map_.write_back) {
+            update_object(itm, payer);
+            return;
+        }
+
+        if (!itm.dirty_) {
+            itm.dirty_ = true;
+            itm.dirty_payer_ = payer;
+            items_map_.dirty.push_back(item_ptr(&itm));
+        } else if (eosio::name(payer) != same_payer) {
+            itm.dirty_payer_ = payer;
+        }
     }
 
     reference get(const primary_key_t pk, const char* error_msg = "unable to find key") const {
@@ -1583,6 +2323,11 @@ public:
 
         chaindb_assert(is_same_multidx(itm), "object passed to erase is not in multi_index");
 
+        // the pending write of the erased object is dropped,
+        // other objects are written to keep the order of updates and deletes as it was without the write-back mode
+        const_cast<item&>(itm).dirty_ = false;
+        flush_dirty_objects();
+
         auto pk = primary_key_extractor_type()(obj);
         remove_object_from_cache(pk);
         internal_use_do_not_use::chaindb_delete(code(), scope(), table_name(), payer, pk);
@@ -1611,6 +2356,7 @@ public:
 
         chaindb_assert(is_same_multidx(itm), "object passed to move_to_ram is not in multi_index");
         chaindb_assert(!itm.service_.in_ram, "object passed to move_to_ram is already in RAM");
+        flush_dirty_objects();
         auto pk = primary_key_extractor_type()(obj);
         internal_use_do_not_use::chaindb_ram_state(code(), scope(), table_name(), pk, true);
         itm.service_.in_ram = true;
@@ -1658,6 +2404,7 @@ public:
 
         chaindb_assert(is_same_multidx(itm), "object passed to move_to_archive is not in multi_index");
         chaindb_assert(itm.service_.in_ram,  "object passed to move_to_archive is already in archive");
+        flush_dirty_objects();
         auto pk = primary_key_extractor_type()(obj);
         internal_use_do_not_use::chaindb_ram_state(code(), scope(), table_name(), pk, false);
         itm.service_.in_ram = false;
@@ -383,4 +383,9 @@ namespace eosio {
 
       EOSLIB_SERIALIZE( asset, (amount)(symbol) )
    };
+
+   /// @cond INTERNAL
+   template<> struct is_raw_serializable<asset> : std::true_type {};
+   static_assert( sizeof(asset) == sizeof(int64_t) + sizeof(symbol), "asset is serialized without padding" );
+   /// @endcond
 }
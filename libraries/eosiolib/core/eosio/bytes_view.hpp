@@ -0,0 +1,153 @@
+/**
+ *  @file
+ *  @copyright defined in LICENSE
+ */
+#pragma once
+
+#include "datastream.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace eosio {
+
+   /**
+    * @defgroup bytes_view Bytes View
+    * @ingroup core
+    * @brief Non-owning views of serialized data
+    */
+
+   /**
+    * A non-owning view of a contiguous sequence of bytes.
+    * It is serialized as `bytes` (the same as std::vector<char>), but is deserialized without a copy:
+    * the view points directly into the buffer of the datastream.
+    *
+    * @ingroup bytes_view
+    * @note A deserialized view is valid only while the source buffer is alive.
+    * The dispatchers keep the action data in the action-data arena until the action data is read again
+    * (see get_action_data()), so copy the data to std::vector<char> to keep it longer.
+    */
+   class bytes_view {
+      public:
+         using value_type     = char;
+         using size_type      = size_t;
+         using iterator       = const char*;
+         using const_iterator = const char*;
+
+         constexpr bytes_view() = default;
+         constexpr bytes_view( const char* data, size_t size ) : _data(data), _size(size) {}
+         bytes_view( const std::vector<char>& v ) : _data(v.data()), _size(v.size()) {}
+
+         constexpr const char* data()const  { return _data; }
+         constexpr size_t      size()const  { return _size; }
+         constexpr bool        empty()const { return _size == 0; }
+
+         constexpr const_iterator begin()const { return _data; }
+         constexpr const_iterator end()const   { return _data + _size; }
+
+         constexpr char operator[]( size_t i )const { return _data[i]; }
+
+         /**
+          * Copy the viewed bytes
+          *
+          * @return std::vector<char> - An owning copy of the bytes
+          */
+         std::vector<char> to_vector()const { return std::vector<char>( begin(), end() ); }
+
+         friend bool operator == ( const bytes_view& a, const bytes_view& b ) {
+            return a._size == b._size && (a._size == 0 || memcmp( a._data, b._data, a._size ) == 0);
+         }
+
+         friend bool operator != ( const bytes_view& a, const bytes_view& b ) {
+            return !(a == b);
+         }
+
+      private:
+         const char* _data = nullptr;
+         size_t      _size = 0;
+   };
+
+   /// @cond INTERNAL
+   namespace _detail {
+      template<typename Stream>
+      const char* read_view( datastream<Stream>& ds, size_t& size ) {
+         unsigned_int s;
+         ds >> s;
+         eosio::check( s.value <= ds.remaining(), "read" );
+         const char* data = ds.pos();
+         ds.skip( s.value );
+         size = s.value;
+         return data;
+      }
+   } // namespace _detail
+   /// @endcond
+
+   /**
+    *  Serialize a bytes_view into a stream
+    *
+    *  @ingroup bytes_view
+    *  @param ds - The stream to write
+    *  @param v - The value to serialize
+    *  @tparam DataStream - Type of datastream
+    *  @return DataStream& - Reference to the datastream
+    */
+   template<typename DataStream>
+   DataStream& operator << ( DataStream& ds, const bytes_view& v ) {
+      ds << unsigned_int( v.size() );
+      if( v.size() )
+         ds.write( v.data(), v.size() );
+      return ds;
+   }
+
+   /**
+    *  Deserialize a bytes_view from a stream without a copy, the view points into the buffer of the stream
+    *
+    *  @ingroup bytes_view
+    *  @param ds - The stream to read
+    *  @param v - The destination for deserialized value
+    *  @tparam Stream - Type of datastream buffer
+    *  @return datastream<Stream>& - Reference to the datastream
+    */
+   template<typename Stream>
+   datastream<Stream>& operator >> ( datastream<Stream>& ds, bytes_view& v ) {
+      size_t size;
+      const char* data = _detail::read_view( ds, size );
+      v = bytes_view( data, size );
+      return ds;
+   }
+
+   /**
+    *  Serialize a std::string_view into a stream, the same as std::string
+    *
+    *  @ingroup bytes_view
+    *  @param ds - The stream to write
+    *  @param v - The value to serialize
+    *  @tparam Stream - Type of datastream buffer
+    *  @return datastream<Stream>& - Reference to the datastream
+    */
+   template<typename Stream>
+   datastream<Stream>& operator << ( datastream<Stream>& ds, const std::string_view& v ) {
+      ds << unsigned_int( v.size() );
+      if( v.size() )
+         ds.write( v.data(), v.size() );
+      return ds;
+   }
+
+   /**
+    *  Deserialize a std::string_view from a stream without a copy, the view points into the buffer of the stream
+    *
+    *  @ingroup bytes_view
+    *  @param ds - The stream to read
+    *  @param v - The destination for deserialized value
+    *  @tparam Stream - Type of datastream buffer
+    *  @return datastream<Stream>& - Reference to the datastream
+    */
+   template<typename Stream>
+   datastream<Stream>& operator >> ( datastream<Stream>& ds, std::string_view& v ) {
+      size_t size;
+      const char* data = _detail::read_view( ds, size );
+      v = std::string_view( data, size );
+      return ds;
+   }
+
+} // namespace eosio
@@ -5,6 +5,7 @@
 #pragma once
 #include "check.hpp"
 #include "varint.hpp"
+#include "serialize.hpp"
 
 #include <list>
 #include <queue>
@@ -494,12 +495,12 @@ DataStream& operator << ( DataStream& ds, const std::string& v ) {
  */
 template<typename DataStream>
 DataStream& operator >> ( DataStream& ds, std::string& v ) {
-   std::vector<char> tmp;
-   ds >> tmp;
-   if( tmp.size() )
-      v = std::string(tmp.data(),tmp.data()+tmp.size());
-   else
-      v = std::string();
+   unsigned_int s;
+   ds >> s;
+   eosio::check( s.value <= ds.remaining(), "read" );
+   v.resize( s.value );
+   if( s.value )
+      ds.read( v.data(), s.value );
    return ds;
 }
 
@@ -513,13 +514,32 @@ DataStream& operator >> ( DataStream& ds, std::string& v ) {
  *  @tparam N - Size of the array
  *  @return DataStream& - Reference to the datastream
  */
-template<typename DataStream, typename T, std::size_t N>
+template<typename DataStream, typename T, std::size_t N,
+         std::enable_if_t<!is_raw_serializable<T>::value>* = nullptr>
 DataStream& operator << ( DataStream& ds, const std::array<T,N>& v ) {
    for( const auto& i : v )
       ds << i;
    return ds;
 }
 
+/**
+ *  Serialize a fixed size std::array of raw serializable type
+ *
+ *  @brief Serialize a fixed size std::array of raw serializable type with a single write
+ *  @param ds - The stream to write
+ *  @param v - The value to serialize
+ *  @tparam DataStream - Type of datastream
+ *  @tparam T - Type of the object contained in the array
+ *  @tparam N - Size of the array
+ *  @return DataStream& - Reference to the datastream
+ */
+template<typename DataStream, typename T, std::size_t N,
+         std::enable_if_t<is_raw_serializable<T>::value>* = nullptr>
+DataStream& operator << ( DataStream& ds, const std::array<T,N>& v ) {
+   ds.write( (const char*)v.data(), N * sizeof(T) );
+   return ds;
+}
+
 
 /**
  *  Deserialize a fixed size std::array
@@ -532,13 +552,32 @@ DataStream& operator << ( DataStream& ds, const std::array<T,N>& v ) {
  *  @tparam N - Size of the array
  *  @return DataStream& - Reference to the datastream
  */
-template<typename DataStream, typename T, std::size_t N>
+template<typename DataStream, typename T, std::size_t N,
+         std::enable_if_t<!is_raw_serializable<T>::value>* = nullptr>
 DataStream& operator >> ( DataStream& ds, std::array<T,N>& v ) {
    for( auto& i : v )
       ds >> i;
    return ds;
 }
 
+/**
+ *  Deserialize a fixed size std::array of raw serializable type
+ *
+ *  @brief Deserialize a fixed size std::array of raw serializable type with a single read
+ *  @param ds - The stream to read
+ *  @param v - The destination for deserialized value
+ *  @tparam DataStream - Type of datastream
+ *  @tparam T - Type of the object contained in the array
+ *  @tparam N - Size of the array
+ *  @return DataStream& - Reference to the datastream
+ */
+template<typename DataStream, typename T, std::size_t N,
+         std::enable_if_t<is_raw_serializable<T>::value>* = nullptr>
+DataStream& operator >> ( DataStream& ds, std::array<T,N>& v ) {
+   ds.read( (char*)v.data(), N * sizeof(T) );
+   return ds;
+}
+
 namespace _datastream_detail {
    /**
     * Check if type T is a pointer
@@ -669,18 +708,20 @@ DataStream& operator >> ( DataStream& ds, T (&v)[N] ) {
 }
 
 /**
- *  Serialize a vector of char
+ *  Serialize a vector of raw serializable type, e.g. char, uint64_t or name
  *
- *  @brief Serialize a vector of char
+ *  @brief Serialize a vector of raw serializable type with a single write
  *  @param ds - The stream to write
  *  @param v - The value to serialize
  *  @tparam DataStream - Type of datastream
+ *  @tparam T - Type of the object contained in the vector
  *  @return DataStream& - Reference to the datastream
  */
-template<typename DataStream>
-DataStream& operator << ( DataStream& ds, const std::vector<char>& v ) {
+template<typename DataStream, typename T,
+         std::enable_if_t<is_raw_serializable<T>::value>* = nullptr>
+DataStream& operator << ( DataStream& ds, const std::vector<T>& v ) {
    ds << unsigned_int( v.size() );
-   ds.write( v.data(), v.size() );
+   ds.write( (const char*)v.data(), v.size() * sizeof(T) );
    return ds;
 }
 
@@ -694,7 +735,8 @@ DataStream& operator << ( DataStream& ds, const std::vector<char>& v ) {
  *  @tparam T - Type of the object contained in the vector
  *  @return DataStream& - Reference to the datastream
  */
-template<typename DataStream, typename T>
+template<typename DataStream, typename T,
+         std::enable_if_t<!is_raw_serializable<T>::value>* = nullptr>
 DataStream& operator << ( DataStream& ds, const std::vector<T>& v ) {
    ds << unsigned_int( v.size() );
    for( const auto& i : v )
@@ -703,20 +745,23 @@ DataStream& operator << ( DataStream& ds, const std::vector<T>& v ) {
 }
 
 /**
- *  Deserialize a vector of char
+ *  Deserialize a vector of raw serializable type, e.g. char, uint64_t or name
  *
- *  @brief Deserialize a vector of char
+ *  @brief Deserialize a vector of raw serializable type with a single read
  *  @param ds - The stream to read
  *  @param v - The destination for deserialized value
  *  @tparam DataStream - Type of datastream
+ *  @tparam T - Type of the object contained in the vector
  *  @return DataStream& - Reference to the datastream
  */
-template<typename DataStream>
-DataStream& operator >> ( DataStream& ds, std::vector<char>& v ) {
+template<typename DataStream, typename T,
+         std::enable_if_t<is_raw_serializable<T>::value>* = nullptr>
+DataStream& operator >> ( DataStream& ds, std::vector<T>& v ) {
    unsigned_int s;
    ds >> s;
+   eosio::check( s.value <= ds.remaining() / sizeof(T), "read" );
    v.resize( s.value );
-   ds.read( v.data(), v.size() );
+   ds.read( (char*)v.data(), v.size() * sizeof(T) );
    return ds;
 }
 
@@ -730,7 +775,8 @@ DataStream& operator >> ( DataStream& ds, std::vector<char>& v ) {
  *  @tparam T - Type of the object contained in the vector
  *  @return DataStream& - Reference to the datastream
  */
-template<typename DataStream, typename T>
+template<typename DataStream, typename T,
+         std::enable_if_t<!is_raw_serializable<T>::value>* = nullptr>
 DataStream& operator >> ( DataStream& ds, std::vector<T>& v ) {
    unsigned_int s;
    ds >> s;
@@ -271,6 +271,11 @@ namespace eosio {
       EOSLIB_SERIALIZE( name, (value) )
    };
 
+   /// @cond INTERNAL
+   template<> struct is_raw_serializable<name> : std::true_type {};
+   static_assert( sizeof(name) == sizeof(uint64_t), "name is serialized as uint64_t" );
+   /// @endcond
+
    namespace detail {
       template <char... Str>
       struct to_const_char_arr {
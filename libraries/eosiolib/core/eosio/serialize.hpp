@@ -1,9 +1,12 @@
+#pragma once
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/preprocessor/seq/enum.hpp>
 #include <boost/preprocessor/seq/size.hpp>
 #include <boost/preprocessor/seq/seq.hpp>
 #include <boost/preprocessor/stringize.hpp>
 
+#include <type_traits>
+
 #define EOSLIB_REFLECT_MEMBER_OP( r, OP, elem ) \
   OP t.elem
 
@@ -50,3 +53,18 @@
     ds >> static_cast<BASE&>(t); \
     return ds BOOST_PP_SEQ_FOR_EACH( EOSLIB_REFLECT_MEMBER_OP, >>, MEMBERS );\
  }
+
+namespace eosio {
+   /**
+    *  Defines whether the serialized form of a type is the same as its representation in memory.
+    *  Containers of such types are serialized and deserialized by a single memcpy.
+    *  Arithmetic types (except bool) and enums are raw serializable,
+    *  other types can be marked by a specialization of this template.
+    *
+    *  @ingroup serialize
+    *  @tparam T - the type to check
+    */
+   template<typename T>
+   struct is_raw_serializable : std::integral_constant<bool,
+      (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value> {};
+}
@@ -204,6 +204,11 @@ namespace eosio {
       uint64_t value = 0;
    };
 
+   /// @cond INTERNAL
+   template<> struct is_raw_serializable<symbol_code> : std::true_type {};
+   static_assert( sizeof(symbol_code) == sizeof(uint64_t), "symbol_code is serialized as uint64_t" );
+   /// @endcond
+
    /**
     *  Serialize a symbol_code into a stream
     *
@@ -340,6 +345,11 @@ namespace eosio {
       uint64_t value = 0;
    };
 
+   /// @cond INTERNAL
+   template<> struct is_raw_serializable<symbol> : std::true_type {};
+   static_assert( sizeof(symbol) == sizeof(uint64_t), "symbol is serialized as uint64_t" );
+   /// @endcond
+
    /**
     *  Serialize a symbol into a stream
     *
@@ -1,31 +1,99 @@
 #include <cstring>
+#include <cstdint>
+
+// Built with -mbulk-memory (eosio_cmem_bulk) the copy and fill functions are single
+// memory.copy/memory.fill instructions, otherwise they are loops over 8-byte words:
+// a byte loop up to the alignment boundary of the destination, the word loop and a byte loop for the tail.
+namespace {
+   using word_t = uint64_t;
+   constexpr size_t word_size = sizeof(word_t);
+
+   inline bool is_aligned( const void* ptr ) {
+      return ((size_t)ptr & (word_size-1)) == 0;
+   }
+
+   inline word_t load_word( const uint8_t* p ) {
+      word_t w;
+      __builtin_memcpy( &w, p, word_size ); // unaligned load
+      return w;
+   }
+
+   inline void copy_forward( uint8_t* p1, const uint8_t* p2, size_t n ) {
+      while ( n && !is_aligned(p1) ) {
+         *p1++ = *p2++;
+         --n;
+      }
+      for ( ; n >= word_size; n -= word_size, p1 += word_size, p2 += word_size )
+         *(word_t*)p1 = load_word( p2 );
+      while ( n-- )
+         *p1++ = *p2++;
+   }
+
+   inline void copy_backward( uint8_t* p1, const uint8_t* p2, size_t n ) {
+      p1 += n;
+      p2 += n;
+      while ( n && !is_aligned(p1) ) {
+         *--p1 = *--p2;
+         --n;
+      }
+      for ( ; n >= word_size; n -= word_size ) {
+         p1 -= word_size;
+         p2 -= word_size;
+         *(word_t*)p1 = load_word( p2 );
+      }
+      while ( n-- )
+         *--p1 = *--p2;
+   }
+} // namespace
 
 extern "C" {
    void* memset( void* ptr, int c, size_t n ) {
+#ifdef __wasm_bulk_memory__
+      return __builtin_memset( ptr, c, n );
+#else
       uint8_t* p = (uint8_t*)ptr;
-      for ( size_t i=0; i < n; i++ )
-         p[i] = (uint8_t)c;
+      while ( n && !is_aligned(p) ) {
+         *p++ = (uint8_t)c;
+         --n;
+      }
+      const word_t w = word_t(0x0101010101010101ULL) * (uint8_t)c;
+      for ( ; n >= word_size; n -= word_size, p += word_size )
+         *(word_t*)p = w;
+      while ( n-- )
+         *p++ = (uint8_t)c;
       return ptr;
+#endif
    }
    void* memcpy( void* ptr1, const void* ptr2, size_t n ) {
-      uint8_t* p1 = (uint8_t*)ptr1;
-      const uint8_t* p2 = (const uint8_t*)ptr2;
-      for ( size_t i=0; i < n; i++ )
-         p1[i] = p2[i];
+#ifdef __wasm_bulk_memory__
+      return __builtin_memcpy( ptr1, ptr2, n );
+#else
+      copy_forward( (uint8_t*)ptr1, (const uint8_t*)ptr2, n );
       return ptr1;
+#endif
    }
    void* memmove( void* ptr1, const void* ptr2, size_t n ) {
+#ifdef __wasm_bulk_memory__
+      return __builtin_memmove( ptr1, ptr2, n );
+#else
       uint8_t* p1 = (uint8_t*)ptr1;
       const uint8_t* p2 = (const uint8_t*)ptr2;
-      uint8_t* p3 = new uint8_t[n];
-      memcpy( p3, p2, n );
-      memcpy( p1, p3, n );
-      delete[] p3;
+      // copying forward is safe unless the destination starts inside of the source
+      if ( p1 <= p2 || p1 >= p2 + n )
+         copy_forward( p1, p2, n );
+      else
+         copy_backward( p1, p2, n );
       return ptr1;
+#endif
    }
    int memcmp( const void* ptr1, const void* ptr2, size_t n ) {
       const uint8_t* p1 = (uint8_t*)ptr1;
       const uint8_t* p2 = (uint8_t*)ptr2;
+      // skip equal words, the first different word is compared byte by byte below
+      for ( ; n >= word_size && load_word(p1) == load_word(p2); n -= word_size ) {
+         p1 += word_size;
+         p2 += word_size;
+      }
       for ( size_t i=0; i < n; i++ ) {
          if ( p1[i] < p2[i] )
             return -1;
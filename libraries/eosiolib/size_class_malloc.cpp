@@ -0,0 +1,148 @@
+#include <memory>
+#include <cstring>
+#include "core/eosio/check.hpp"
+
+#ifdef EOSIO_NATIVE
+   extern "C" {
+      size_t _current_memory();
+      size_t _grow_memory(size_t);
+   }
+#define CURRENT_MEMORY _current_memory()
+#define GROW_MEMORY(X) _grow_memory(X)
+#else
+#define CURRENT_MEMORY __builtin_wasm_current_memory()
+#define GROW_MEMORY(X) __builtin_wasm_grow_memory(X)
+#endif
+
+namespace eosio {
+   // Segregated free lists with power-of-two size classes of the payload.
+   // Every block is a header which keeps its class followed by the payload, so a 2^k request takes
+   // a 2^k payload, and malloc and free are O(1):
+   //   malloc pops the free list of the class or cuts a new block from the end of the heap,
+   //   free pushes the block to the free list of its class. Freed blocks are never merged or split.
+   struct size_class_malloc {
+      static constexpr uint32_t wasm_page_size = 64*1024;
+      static constexpr size_t   header_size = 8; // keeps payloads aligned by 8
+      static constexpr uint32_t min_class = 4;   // 16 bytes payload
+      static constexpr uint32_t max_class = sizeof(size_t)*8 - 1;
+
+      struct free_block {
+         free_block* next;
+      };
+
+      inline char* align(char* ptr, uint8_t align_amt) {
+         return (char*)((((size_t)ptr) + align_amt-1) & ~(align_amt-1));
+      }
+
+      size_class_malloc() {
+         volatile uintptr_t heap_base = 0; // linker places this at address 0
+         last_ptr = align(*(char**)heap_base, header_size);
+         next_page = CURRENT_MEMORY;
+      }
+
+      static uint32_t size_class(size_t sz) {
+         if (sz <= (size_t(1) << min_class))
+            return min_class;
+         return sizeof(unsigned long)*8 - __builtin_clzl(static_cast<unsigned long>(sz - 1));
+      }
+
+      static uint32_t& class_of(char* ptr) {
+         return *reinterpret_cast<uint32_t*>(ptr - header_size);
+      }
+
+      static size_t capacity(char* ptr) {
+         return size_t(1) << class_of(ptr);
+      }
+
+      char* allocate_block(size_t block_size) {
+         char* block = last_ptr;
+         eosio::check(block_size <= size_t(-1) - (size_t)block, "failed to allocate pages");
+         last_ptr = block + block_size;
+
+         const size_t heap_end = (size_t)last_ptr;
+         if ((next_page << 16) < heap_end) {
+            const size_t pages_to_alloc = ((heap_end - (next_page << 16)) + wasm_page_size-1) >> 16;
+            eosio::check(GROW_MEMORY(pages_to_alloc) != -1, "failed to allocate pages");
+            next_page += pages_to_alloc;
+         }
+         return block;
+      }
+
+      char* malloc(size_t sz) {
+         if (sz == 0)
+            return nullptr;
+
+         eosio::check(sz <= (size_t(1) << max_class), "failed to allocate pages");
+         const uint32_t cls = size_class(sz);
+
+         char* ptr;
+         if (free_lists[cls]) {
+            ptr = reinterpret_cast<char*>(free_lists[cls]);
+            free_lists[cls] = free_lists[cls]->next;
+         } else {
+            ptr = allocate_block(header_size + (size_t(1) << cls)) + header_size;
+            class_of(ptr) = cls;
+         }
+         return ptr;
+      }
+
+      void free(char* ptr) {
+         if (ptr == nullptr)
+            return;
+
+         auto block = reinterpret_cast<free_block*>(ptr);
+         const uint32_t cls = class_of(ptr);
+         block->next = free_lists[cls];
+         free_lists[cls] = block;
+      }
+
+      char* realloc(char* ptr, size_t sz) {
+         if (ptr == nullptr)
+            return malloc(sz);
+
+         if (sz == 0) {
+            free(ptr);
+            return nullptr;
+         }
+
+         const size_t cap = capacity(ptr);
+         if (sz <= cap)
+            return ptr;
+
+         char* ret = malloc(sz);
+         memcpy(ret, ptr, cap);
+         free(ptr);
+         return ret;
+      }
+
+      char*       last_ptr;
+      size_t      next_page;
+      free_block* free_lists[max_class + 1];
+   };
+   size_class_malloc _size_class_malloc;
+} // ns eosio
+
+extern "C" {
+
+void* malloc(size_t size) {
+   return eosio::_size_class_malloc.malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+   if (count != 0 && size > size_t(-1) / count)
+      return nullptr;
+   if (void* ptr = eosio::_size_class_malloc.malloc(count*size)) {
+      memset(ptr, 0, count*size);
+      return ptr;
+   }
+   return nullptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+   return eosio::_size_class_malloc.realloc((char*)ptr, size);
+}
+
+void free(void* ptr) {
+   eosio::_size_class_malloc.free((char*)ptr);
+}
+}
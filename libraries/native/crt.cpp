@@ -2,8 +2,13 @@
 #include <eosio/action.hpp>
 #include "native/eosio/intrinsics.hpp"
 #include "native/eosio/crt.hpp"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <map>
+#include <string>
+#include <vector>
 #include <stdio.h>
 #include <setjmp.h>
 
@@ -13,6 +18,11 @@ eosio::cdt::output_stream std_err;
 extern "C" {
    int main(int, char**);
    char* _mmap();
+   struct ___timespec {
+      int64_t tv_sec;
+      int64_t tv_nsec;
+   };
+   int ___clock_gettime(int, ___timespec*);
 
    static jmp_buf env;
    static jmp_buf test_env;
@@ -23,10 +33,26 @@ extern "C" {
    char* ___heap_base_ptr;
    size_t ___pages;
    void ___putc(char c);
+   int  ___fork();
+   int  ___wait4(int pid, int* status, int options, void* rusage);
+   long ___write(int fd, const void* buffer, size_t size);
+   void ___exit(int code);
    bool ___disable_output;
    bool ___has_failed;
    bool ___earlier_unit_test_has_failed;
 
+   // test workers, see __run_test_in_worker
+   static size_t ___test_workers;
+   static std::map<int, const char*> ___running_tests;
+   static std::string* ___output_capture;
+
+   static void __putc(char c) {
+      if (___output_capture)
+         ___output_capture->push_back(c);
+      else
+         ___putc(c);
+   }
+
    void* __get_heap_base() {
       return ___heap_base_ptr;
    }
@@ -36,10 +62,18 @@ extern "C" {
    }
 
    size_t _grow_memory(size_t size) {
-      if ((___heap_ptr + (size*64*1024)) > (___heap_ptr + 100*1024*1024))
+      if ((___pages + size)*64*1024 > 100*1024*1024)
          eosio_assert(false, "__builtin_wasm_grow_memory");
       ___heap_ptr += (size*64*1024);
-      return ++___pages;
+      const size_t prev_pages = ___pages;
+      ___pages += size;
+      return prev_pages;
+   }
+
+   uint64_t _steady_clock_ns() {
+      ___timespec ts;
+      ___clock_gettime(1 /* CLOCK_MONOTONIC */, &ts);
+      return ts.tv_sec * 1000000000ull + ts.tv_nsec;
    }
 
    void _prints_l(const char* cstr, uint32_t len, uint8_t which) {
@@ -49,7 +83,7 @@ extern "C" {
          else if (which == eosio::cdt::output_stream_kind::std_err)
             std_err.push(cstr[i]);
          if (!___disable_output)
-            ___putc(cstr[i]);
+            __putc(cstr[i]);
       }
    }
 
@@ -60,7 +94,7 @@ extern "C" {
          else if (which == eosio::cdt::output_stream_kind::std_err)
             std_err.push(cstr[i]);
          if (!___disable_output)
-            ___putc(cstr[i]);
+            __putc(cstr[i]);
       }
    }
 
@@ -71,6 +105,122 @@ extern "C" {
       ___env_ptr = &env;
    }
 
+   // Prints the calls of intrinsics sorted by their time, it ignores silence_output()
+   static void __print_intrinsic_trace() {
+      using namespace eosio::native;
+      auto& in = intrinsics::get();
+      std::vector<size_t> called;
+      for (size_t i = 0; i < intrinsics::INTRINSICS_SIZE; ++i) {
+         if (in.trace_stats[i].calls)
+            called.push_back(i);
+      }
+      std::sort(called.begin(), called.end(), [&](size_t a, size_t b) {
+         return in.trace_stats[a].time_ns > in.trace_stats[b].time_ns;
+      });
+
+      auto column = [](std::string s, size_t width) {
+         return s.size() < width ? std::string(width - s.size(), ' ') + s : s;
+      };
+      std::string out = "intrinsic" + std::string(36 - 9, ' ') + column("calls", 12) + column("bytes", 15) +
+         column("total, us", 14) + column("avg, ns", 11) + "\n";
+      for (auto i: called) {
+         const auto& st = in.trace_stats[i];
+         std::string name = intrinsics::get_name(intrinsics::intrinsic_name(i));
+         out += name + std::string(name.size() < 36 ? 36 - name.size() : 1, ' ') +
+            column(std::to_string(st.calls), 12) + column(std::to_string(st.bytes), 15) +
+            column(std::to_string(st.time_ns / 1000), 14) + column(std::to_string(st.time_ns / st.calls), 11) + "\n";
+      }
+
+      const bool disable_output = ___disable_output;
+      ___disable_output = false;
+      _prints_l(out.c_str(), out.size(), eosio::cdt::output_stream_kind::none);
+      ___disable_output = disable_output;
+   }
+
+   static void __print_failure(const char* name, const std::string& reason) {
+      const std::string msg = std::string("\033[1;37m") + name + " \033[0;37munit test \033[1;31mfailed\033[0m (" + reason + ")\n";
+      const bool disable_output = ___disable_output;
+      ___disable_output = false;
+      _prints_l(msg.c_str(), msg.size(), eosio::cdt::output_stream_kind::none);
+      ___disable_output = disable_output;
+   }
+
+   static void __wait_test_worker();
+
+   // The value of -j, only digits are accepted like in the options of parse_bench_args
+   static bool __parse_test_workers(const char* arg) {
+      size_t workers = 0;
+      for (const char* c = arg; *c; ++c) {
+         if (*c < '0' || *c > '9' || workers > 0xFFFF)
+            return false;
+         workers = workers * 10 + (*c - '0');
+      }
+      if (workers == 0)
+         return false;
+      ___test_workers = workers;
+      return true;
+   }
+
+   // Runs the test in a forked worker, which has its own copy of the heap, the output streams and the intrinsics.
+   // The output of the worker is written at once when it exits, the exit code is the result of the test.
+   bool __run_test_in_worker(const char* name, void (*test)()) {
+      if (___test_workers == 0)
+         return false;
+      while (___running_tests.size() >= ___test_workers)
+         __wait_test_worker();
+
+      const int pid = ___fork();
+      if (pid < 0)
+         return false;
+      if (pid > 0) {
+         ___running_tests[pid] = name;
+         return true;
+      }
+
+      std::string output;
+      ___output_capture = &output;
+      ___running_tests.clear();
+      ___test_workers = 0;
+      __reset_env();
+      if (setjmp(env) == 0) {
+         test();
+      } else {
+         __print_failure(name, "aborted");
+         ___has_failed = true;
+      }
+      if (eosio::native::intrinsics::get().tracing)
+         __print_intrinsic_trace();
+      for (size_t written = 0; written < output.size();) {
+         const long n = ___write(1, output.data() + written, output.size() - written);
+         if (n <= 0)
+            break;
+         written += n;
+      }
+      ___exit(___has_failed ? 1 : 0);
+      return true;
+   }
+
+   static void __wait_test_worker() {
+      int status = 0;
+      const int pid = ___wait4(-1, &status, 0, nullptr);
+      auto itr = ___running_tests.find(pid);
+      if (pid <= 0 || itr == ___running_tests.end()) {
+         ___running_tests.clear();
+         return;
+      }
+      const bool exited = (status & 0x7f) == 0;
+      if (!exited || (status >> 8) & 0xff)
+         ___has_failed = true;
+      if (!exited)
+         __print_failure(itr->second, "worker killed by signal " + std::to_string(status & 0x7f));
+      ___running_tests.erase(itr);
+   }
+
+   void __wait_test_workers() {
+      while (!___running_tests.empty())
+         __wait_test_worker();
+   }
+
    int _wrap_main(int argc, char** argv) {
       using namespace eosio::native;
       int ret_val = 0;
@@ -163,12 +313,37 @@ extern "C" {
          });
 
 
+      // --trace-intrinsics and -j <workers> are consumed here, so tests and benchmarks don't see them
+      for (int i = 1; i < argc; ++i) {
+         int consumed = 0;
+         if (strcmp(argv[i], "--trace-intrinsics") == 0) {
+            intrinsics::get().tracing = true;
+            consumed = 1;
+         } else if (strcmp(argv[i], "-j") == 0) {
+            if (i + 1 == argc || !__parse_test_workers(argv[i + 1])) {
+               static const char error[] = "-j expects a positive number of workers\n";
+               ___write(2, error, sizeof(error) - 1);
+               return -1;
+            }
+            consumed = 2;
+         }
+         if (consumed) {
+            for (int j = i; j + consumed <= argc; ++j)
+               argv[j] = argv[j + consumed];
+            argc -= consumed;
+            --i;
+         }
+      }
+
       jmp_ret = setjmp(env);
       if (jmp_ret == 0) {
          ret_val = main(argc, argv);
       } else {
          ret_val = -1;
       }
+      __wait_test_workers();
+      if (intrinsics::get().tracing)
+         __print_intrinsic_trace();
       return ret_val;
    }
 
@@ -1,11 +1,21 @@
 .global _start
 .global ___putc
 .global _mmap
+.global ___clock_gettime
+.global ___fork
+.global ___wait4
+.global ___write
+.global ___exit
 .global setjmp
 .global longjmp
 .type _start,@function
 .type ___putc,@function
 .type _mmap,@function
+.type ___clock_gettime,@function
+.type ___fork,@function
+.type ___wait4,@function
+.type ___write,@function
+.type ___exit,@function
 .type setjmp,@function
 .type longjmp,@function
 
@@ -43,6 +53,31 @@ _mmap:
    syscall
    ret 
 
+___clock_gettime:
+   mov $228, %eax # clock_gettime(clock_id, timespec*)
+   syscall
+   ret
+
+___fork:
+   mov $57, %eax
+   syscall
+   ret
+
+___wait4:
+   mov %rcx, %r10 # wait4(pid, status*, options, rusage*)
+   mov $61, %eax
+   syscall
+   ret
+
+___write:
+   mov $1, %eax # write(fd, buffer, size)
+   syscall
+   ret
+
+___exit:
+   mov $60, %eax
+   syscall
+
 setjmp:
 	mov %rbx, 0(%rdi)
 	mov %rbp, 8(%rdi)
@@ -145,6 +145,71 @@ extern "C" {
       return intrinsics::get().call<intrinsics::get_context_free_data>(index, buff, size);
    }
 
+   // chaindb
+   int32_t chaindb_begin( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw index ) {
+      return intrinsics::get().call<intrinsics::chaindb_begin>(code, scope, table, index);
+   }
+   int32_t chaindb_end( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw index ) {
+      return intrinsics::get().call<intrinsics::chaindb_end>(code, scope, table, index);
+   }
+   int32_t chaindb_lower_bound( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw index, void* key, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_lower_bound>(code, scope, table, index, key, size);
+   }
+   int32_t chaindb_lower_bound_pk( eosio::name::raw code, uint64_t scope, eosio::name::raw table, uint64_t pk ) {
+      return intrinsics::get().call<intrinsics::chaindb_lower_bound_pk>(code, scope, table, pk);
+   }
+   int32_t chaindb_upper_bound( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw index, void* key, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_upper_bound>(code, scope, table, index, key, size);
+   }
+   int32_t chaindb_upper_bound_pk( eosio::name::raw code, uint64_t scope, eosio::name::raw table, uint64_t pk ) {
+      return intrinsics::get().call<intrinsics::chaindb_upper_bound_pk>(code, scope, table, pk);
+   }
+   int32_t chaindb_locate_to( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw index, uint64_t pk, void* key, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_locate_to>(code, scope, table, index, pk, key, size);
+   }
+   int32_t chaindb_clone( eosio::name::raw code, int32_t cursor ) {
+      return intrinsics::get().call<intrinsics::chaindb_clone>(code, cursor);
+   }
+   void chaindb_close( eosio::name::raw code, int32_t cursor ) {
+      return intrinsics::get().call<intrinsics::chaindb_close>(code, cursor);
+   }
+   uint64_t chaindb_current( eosio::name::raw code, int32_t cursor ) {
+      return intrinsics::get().call<intrinsics::chaindb_current>(code, cursor);
+   }
+   uint64_t chaindb_next( eosio::name::raw code, int32_t cursor ) {
+      return intrinsics::get().call<intrinsics::chaindb_next>(code, cursor);
+   }
+   uint64_t chaindb_prev( eosio::name::raw code, int32_t cursor ) {
+      return intrinsics::get().call<intrinsics::chaindb_prev>(code, cursor);
+   }
+   int32_t chaindb_datasize( eosio::name::raw code, int32_t cursor ) {
+      return intrinsics::get().call<intrinsics::chaindb_datasize>(code, cursor);
+   }
+   uint64_t chaindb_data( eosio::name::raw code, int32_t cursor, void* data, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_data>(code, cursor, data, size);
+   }
+   int32_t chaindb_service( eosio::name::raw code, int32_t cursor, void* data, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_service>(code, cursor, data, size);
+   }
+   int32_t chaindb_fetch( eosio::name::raw code, int32_t cursor, int32_t count, void* data, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_fetch>(code, cursor, count, data, size);
+   }
+   uint64_t chaindb_available_primary_key( eosio::name::raw code, uint64_t scope, eosio::name::raw table ) {
+      return intrinsics::get().call<intrinsics::chaindb_available_primary_key>(code, scope, table);
+   }
+   int32_t chaindb_insert( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw payer, uint64_t pk, void* data, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_insert>(code, scope, table, payer, pk, data, size);
+   }
+   int32_t chaindb_update( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw payer, uint64_t pk, void* data, int32_t size ) {
+      return intrinsics::get().call<intrinsics::chaindb_update>(code, scope, table, payer, pk, data, size);
+   }
+   int32_t chaindb_delete( eosio::name::raw code, uint64_t scope, eosio::name::raw table, eosio::name::raw payer, uint64_t pk ) {
+      return intrinsics::get().call<intrinsics::chaindb_delete>(code, scope, table, payer, pk);
+   }
+   void chaindb_ram_state( eosio::name::raw code, uint64_t scope, eosio::name::raw table, uint64_t pk, int32_t in_ram ) {
+      return intrinsics::get().call<intrinsics::chaindb_ram_state>(code, scope, table, pk, in_ram);
+   }
+
    // softfloat
    static constexpr uint32_t inv_float_eps = 0x4B000000;
    static constexpr uint64_t inv_double_eps = 0x4330000000000000;
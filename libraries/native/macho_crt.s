@@ -1,6 +1,11 @@
 .global start
 .global ____putc
 .global __mmap
+.global ____clock_gettime
+.global ____fork
+.global ____wait4
+.global ____write
+.global ____exit
 .global _setjmp
 .global _longjmp
 
@@ -38,6 +43,54 @@ __mmap:
    syscall
    ret 
 
+# there is no clock_gettime syscall, so the time is taken from gettimeofday 0x74 or 116,
+# which returns the seconds in %rax and the microseconds in %edx
+____clock_gettime:
+   mov %rsi, %r9        # timespec
+   mov %rsi, %rdi
+   xor %esi, %esi
+   xor %edx, %edx
+   mov $0x2000074, %eax
+   syscall
+   test %rax, %rax
+   jz 1f
+   mov %rax, 0(%r9)
+   mov %edx, 8(%r9)
+1:
+   movslq 8(%r9), %rax
+   imul $1000, %rax
+   mov %rax, 8(%r9)
+   xor %eax, %eax
+   ret
+
+____fork:
+   mov $0x2000002, %eax # fork syscall 0x2, %edx is 1 in the child
+   syscall
+   jc 2f
+   test %edx, %edx
+   jz 1f
+   xor %eax, %eax
+1:
+   ret
+2:
+   mov $-1, %rax
+   ret
+
+____wait4:
+   mov %rcx, %r10
+   mov $0x2000007, %eax # wait4 syscall 0x7
+   syscall
+   ret
+
+____write:
+   mov $0x2000004, %eax # write syscall 0x4
+   syscall
+   ret
+
+____exit:
+   mov $0x2000001, %eax # exit syscall 0x1
+   syscall
+
 _setjmp:
 	mov %rbx, 0(%rdi)
 	mov %rbp, 8(%rdi)
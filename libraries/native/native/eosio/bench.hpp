@@ -0,0 +1,227 @@
+#pragma once
+#include "tester.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /// Options of the benchmarks, parse_bench_args() sets them from the command line
+   struct bench_config {
+      uint32_t samples       = 100;    // timed samples
+      uint32_t warmup        = 10;     // untimed samples after the calibration of the batch
+      uint64_t min_sample_ns = 20000;  // the batch is doubled until a sample takes at least that time
+      bool     json          = false;  // print results as JSON lines
+   };
+
+   inline bench_config& bench_options() {
+      static bench_config cfg;
+      return cfg;
+   }
+
+   /// Keeps the value, so the compiler can't remove the code which computes it
+   template <typename T>
+   inline void do_not_optimize(const T& value) {
+      asm volatile("" : : "r,m"(value) : "memory");
+   }
+
+   /**
+    * State of one benchmark, see EOSIO_BENCH_BEGIN.
+    * The loop body runs in samples of `batch` iterations, one sample is timed by two reads of the steady clock,
+    * so the time of short operations isn't hidden by the time of the clock.
+    */
+   class bench_state {
+      public:
+         explicit bench_state(const char* name)
+         : name_(name), config_(bench_options()), warmup_left_(config_.warmup) {
+            times_.reserve(config_.samples);
+         }
+
+         /// Returns true while the loop should run one more iteration
+         bool keep_running() {
+            if (left_ > 0) {
+               --left_;
+               return true;
+            }
+            return next_sample();
+         }
+
+         void report() const {
+            std::vector<double> sorted = times_;
+            std::sort(sorted.begin(), sorted.end());
+            const uint64_t ops = uint64_t(batch_) * times_.size();
+            const int64_t heap_bytes = (int64_t(end_pages_) - int64_t(begin_pages_)) * 64 * 1024;
+
+            std::string out;
+            if (config_.json) {
+               out = std::string("{\"name\":\"") + name_ + "\",\"batch\":" + std::to_string(batch_) +
+                  ",\"samples\":" + std::to_string(times_.size()) +
+                  ",\"min_ns\":" + format(percentile(sorted, 0)) +
+                  ",\"median_ns\":" + format(percentile(sorted, 50)) +
+                  ",\"p99_ns\":" + format(percentile(sorted, 99)) +
+                  ",\"heap_bytes\":" + std::to_string(heap_bytes) + ",\"intrinsics\":{";
+               bool first = true;
+               for (size_t i = 0; i < intrinsics::INTRINSICS_SIZE; ++i) {
+                  if (end_counts_[i] == begin_counts_[i])
+                     continue;
+                  out += std::string(first ? "" : ",") + "\"" + intrinsics::get_name(intrinsics::intrinsic_name(i)) + "\":" +
+                     format(double(end_counts_[i] - begin_counts_[i]) / ops);
+                  first = false;
+               }
+               out += "}}\n";
+            } else {
+               out = std::string("\033[1;37m") + name_ + " \033[0;37m" + format(percentile(sorted, 50)) + " ns/op" +
+                  " (min " + format(percentile(sorted, 0)) + ", p99 " + format(percentile(sorted, 99)) + ")" +
+                  ", " + std::to_string(times_.size()) + " samples of " + std::to_string(batch_) +
+                  ", heap +" + std::to_string(heap_bytes) + " bytes\033[0m\n";
+               for (size_t i = 0; i < intrinsics::INTRINSICS_SIZE; ++i) {
+                  if (end_counts_[i] != begin_counts_[i])
+                     out += std::string("   ") + intrinsics::get_name(intrinsics::intrinsic_name(i)) + ": " +
+                        format(double(end_counts_[i] - begin_counts_[i]) / ops) + " calls/op\n";
+               }
+            }
+
+            bool ___original_disable_output = ___disable_output;
+            silence_output(false);
+            eosio::print(out);
+            silence_output(___original_disable_output);
+         }
+
+      private:
+         static constexpr uint32_t max_batch = 1 << 24;
+
+         bool next_sample() {
+            const uint64_t now = _steady_clock_ns();
+            if (started_) {
+               const uint64_t elapsed = now - start_ns_;
+               if (!timed_) {
+                  if (elapsed < config_.min_sample_ns && batch_ < max_batch)
+                     batch_ *= 2;
+                  else if (warmup_left_ > 0)
+                     --warmup_left_;
+                  if (warmup_left_ == 0 && (elapsed >= config_.min_sample_ns || batch_ >= max_batch)) {
+                     timed_ = true;
+                     snapshot(begin_counts_, begin_pages_);
+                  }
+               } else {
+                  times_.push_back(double(elapsed) / batch_);
+                  if (times_.size() >= config_.samples) {
+                     snapshot(end_counts_, end_pages_);
+                     return false;
+                  }
+               }
+            }
+            started_ = true;
+            left_ = batch_ - 1;
+            start_ns_ = _steady_clock_ns();
+            return true;
+         }
+
+         static void snapshot(std::vector<uint64_t>& counts, size_t& pages) {
+            const auto& calls = intrinsics::get().call_counts;
+            counts.assign(calls, calls + intrinsics::INTRINSICS_SIZE);
+            pages = _current_memory();
+         }
+
+         static double percentile(const std::vector<double>& sorted, uint32_t p) {
+            if (sorted.empty())
+               return 0;
+            return sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)];
+         }
+
+         static std::string format(double v) {
+            const uint64_t hundredths = uint64_t(v * 100 + 0.5);
+            const uint64_t frac = hundredths % 100;
+            return std::to_string(hundredths / 100) + (frac < 10 ? ".0" : ".") + std::to_string(frac);
+         }
+
+         const char*           name_;
+         const bench_config&   config_;
+         uint32_t              warmup_left_;
+         uint32_t              batch_    = 1;
+         uint32_t              left_     = 0;
+         uint64_t              start_ns_ = 0;
+         bool                  started_  = false;
+         bool                  timed_    = false;
+         std::vector<double>   times_;  // ns per iteration of each sample
+         std::vector<uint64_t> begin_counts_;
+         std::vector<uint64_t> end_counts_;
+         size_t                begin_pages_ = 0;
+         size_t                end_pages_   = 0;
+   };
+
+   /**
+    * Parses the options of a benchmark executable:
+    *   -n <samples>  number of timed samples
+    *   -w <samples>  number of warm-up samples
+    *   --json        print results as JSON lines
+    *   -v            don't silence the output of the code
+    */
+   inline bool parse_bench_args(int argc, char** argv) {
+      auto& cfg = bench_options();
+      bool verbose = false;
+      for (int i = 1; i < argc; ++i) {
+         const std::string arg = argv[i];
+         if (arg == "-v") {
+            verbose = true;
+         } else if (arg == "--json") {
+            cfg.json = true;
+         } else if ((arg == "-n" || arg == "-w") && i + 1 < argc) {
+            uint32_t value = 0;
+            for (const char* c = argv[++i]; *c; ++c) {
+               if (*c < '0' || *c > '9')
+                  return false;
+               value = value * 10 + (*c - '0');
+            }
+            if (arg == "-n")
+               cfg.samples = std::max(1u, value);
+            else
+               cfg.warmup = value;
+         } else {
+            return false;
+         }
+      }
+      silence_output(!verbose);
+      return true;
+   }
+
+}} //ns eosio::native
+
+/**
+ * A benchmark is defined like a unit test, the code before EOSIO_BENCH_LOOP isn't timed:
+ *
+ * ```
+ * EOSIO_BENCH_BEGIN(name_to_string)
+ *    eosio::name n = "eosio.token"_n;
+ *    EOSIO_BENCH_LOOP {
+ *       do_not_optimize(n.to_string());
+ *    }
+ * EOSIO_BENCH_END
+ * ```
+ * and it is run by EOSIO_BENCH(name_to_string) in main().
+ * The report has the min, median and p99 time of an iteration, the heap growth by _grow_memory
+ * and the number of intrinsic calls per iteration.
+ */
+#define EOSIO_BENCH_BEGIN(X) \
+   void X() { \
+      eosio::native::bench_state __bench(#X);
+
+#define EOSIO_BENCH_LOOP \
+      while (__bench.keep_running())
+
+#define EOSIO_BENCH_END \
+      __bench.report(); \
+   }
+
+#define EOSIO_BENCH(X) \
+   int X ## _ret = setjmp(*___env_ptr); \
+   if ( X ## _ret == 0 ) \
+      X(); \
+   else { \
+      bool ___original_disable_output = ___disable_output; \
+      silence_output(false); \
+      eosio::print("\033[1;37m", #X, " \033[0;37mbenchmark \033[1;31mfailed\033[0m (aborted)\n"); \
+      ___has_failed = true; \
+      silence_output(___original_disable_output); \
+   }
@@ -0,0 +1,106 @@
+#pragma once
+#include <eosio/multi_index.hpp>
+#include "chaindb_emulator.hpp"
+#include "intrinsics.hpp"
+
+#include <string_view>
+
+namespace eosio { namespace native {
+
+   /**
+    * In-memory chaindb of the native tester.
+    * After use_chaindb() the chaindb intrinsics work on it, so the code with multi_index and singleton runs without a node:
+    *
+    * ```
+    * use_chaindb();
+    * load_chaindb_abi("token"_n, token_abi);  // the ABI emitted by abigen, for the secondary indexes
+    * ...
+    * CHECK_EQUAL( chaindb().ram_usage("alice"_n.value), 24 )
+    * ```
+    * Errors of chaindb fail the test with eosio_assert, so they are caught by CHECK_ASSERT.
+    */
+   inline chaindb_emulator& chaindb() {
+      static chaindb_emulator db([](const char* msg) { eosio_assert(false, msg); });
+      return db;
+   }
+
+   /// Loads the ABI (JSON) of the contract `code`, it must be loaded before the first access to its tables
+   inline void load_chaindb_abi(name code, std::string_view abi) {
+      check(chaindb().load_abi(code.value, abi.data(), abi.size()), "unable to parse the ABI of the contract");
+   }
+
+   /// Sets the chaindb intrinsics to the in-memory chaindb, removes all its rows and drops the object caches of multi_index
+   inline void use_chaindb() {
+      chaindb().clear();
+      eosio::_detail::reset_caches();
+
+      intrinsics::set_intrinsic<intrinsics::chaindb_begin>([](auto code, scope_t scope, auto table, auto index) {
+         return chaindb().begin(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), static_cast<uint64_t>(index));
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_end>([](auto code, scope_t scope, auto table, auto index) {
+         return chaindb().end(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), static_cast<uint64_t>(index));
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_lower_bound>([](auto code, scope_t scope, auto table, auto index, void* key, int32_t size) {
+         return chaindb().lower_bound(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), static_cast<uint64_t>(index),
+            static_cast<const char*>(key), size);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_upper_bound>([](auto code, scope_t scope, auto table, auto index, void* key, int32_t size) {
+         return chaindb().upper_bound(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), static_cast<uint64_t>(index),
+            static_cast<const char*>(key), size);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_lower_bound_pk>([](auto code, scope_t scope, auto table, primary_key_t pk) {
+         return chaindb().lower_bound_pk(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), pk);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_upper_bound_pk>([](auto code, scope_t scope, auto table, primary_key_t pk) {
+         return chaindb().upper_bound_pk(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), pk);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_locate_to>([](auto code, scope_t scope, auto table, auto index, primary_key_t pk, void*, int32_t) {
+         return chaindb().locate_to(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), static_cast<uint64_t>(index), pk);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_clone>([](auto, cursor_t cursor) {
+         return chaindb().clone(cursor);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_close>([](auto, cursor_t cursor) {
+         chaindb().close(cursor);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_current>([](auto, cursor_t cursor) {
+         return chaindb().current(cursor);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_next>([](auto, cursor_t cursor) {
+         return chaindb().next(cursor);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_prev>([](auto, cursor_t cursor) {
+         return chaindb().prev(cursor);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_datasize>([](auto, cursor_t cursor) {
+         return chaindb().datasize(cursor);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_data>([](auto, cursor_t cursor, void* data, int32_t size) {
+         return chaindb().data(cursor, static_cast<char*>(data), size);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_service>([](auto, cursor_t cursor, void* data, int32_t size) {
+         return chaindb().service(cursor, static_cast<char*>(data), size);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_fetch>([](auto, cursor_t cursor, int32_t count, void* data, int32_t size) {
+         return chaindb().fetch(cursor, count, static_cast<char*>(data), size);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_available_primary_key>([](auto code, scope_t scope, auto table) {
+         return chaindb().available_primary_key(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table));
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_insert>([](auto code, scope_t scope, auto table, auto payer, primary_key_t pk, void* data, int32_t size) {
+         return chaindb().insert(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), static_cast<uint64_t>(payer), pk,
+            static_cast<const char*>(data), size);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_update>([](auto code, scope_t scope, auto table, auto payer, primary_key_t pk, void* data, int32_t size) {
+         return chaindb().update(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), static_cast<uint64_t>(payer), pk,
+            static_cast<const char*>(data), size);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_delete>([](auto code, scope_t scope, auto table, auto, primary_key_t pk) {
+         return chaindb().remove(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), pk);
+      });
+      intrinsics::set_intrinsic<intrinsics::chaindb_ram_state>([](auto code, scope_t scope, auto table, primary_key_t pk, int32_t in_ram) {
+         chaindb().ram_state(static_cast<uint64_t>(code), scope, static_cast<uint64_t>(table), pk, in_ram);
+      });
+   }
+
+}} // ns eosio::native
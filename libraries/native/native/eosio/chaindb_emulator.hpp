@@ -0,0 +1,949 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    * In-memory chaindb: the tables behind the chaindb_* intrinsics, with ordered primary and secondary indexes,
+    * cursors, the RAM state of rows and the RAM usage of payers.
+    *
+    * Secondary indexes are built from the index definitions of the contract ABI (see load_abi()),
+    * the ABI must be loaded before the first access to the tables of the contract.
+    * The keys are compared by the ABI types of the index fields, in the way chaindb orders them.
+    *
+    * The emulator is self-contained (no eosio headers), so it is shared by the native tester
+    * and the wasm2c benchmark host. Errors are reported with the `fail` callback, it must not return.
+    */
+   class chaindb_emulator {
+      public:
+         using fail_callback = void (*)(const char*);
+
+         static constexpr uint64_t end_primary_key = static_cast<uint64_t>(-1);
+
+         explicit chaindb_emulator(fail_callback fail) : fail_(fail) {}
+
+         /// Loads the ABI (JSON) of the contract `code`, returns false if it can't be parsed
+         bool load_abi(uint64_t code, const char* json, size_t size) {
+            json_value root;
+            json_parser parser{json, json + size};
+            if (!parser.parse(root) || root.kind != json_value::object_kind)
+               return false;
+            abi_def abi;
+            if (!abi.load(root))
+               return false;
+            abis_[code] = std::move(abi);
+            return true;
+         }
+
+         /// Removes all rows, cursors and RAM usage, the ABIs are kept
+         void clear() {
+            tables_.clear();
+            cursors_.clear();
+            ram_usage_.clear();
+            next_cursor_ = 1;
+         }
+
+         int64_t ram_usage(uint64_t payer) const {
+            auto itr = ram_usage_.find(payer);
+            return itr == ram_usage_.end() ? 0 : itr->second;
+         }
+
+         size_t open_cursors() const { return cursors_.size(); }
+
+         int32_t begin(uint64_t code, uint64_t scope, uint64_t table, uint64_t index) {
+            auto& tbl = get_table(code, scope, table);
+            const int idx = find_index(tbl, index);
+            if (idx < 0)
+               return open(tbl, idx, tbl.rows.empty() ? end_primary_key : tbl.rows.begin()->first);
+            const auto& entries = tbl.indexes[idx].entries;
+            if (entries.empty())
+               return open(tbl, idx, end_primary_key);
+            return open(tbl, idx, entries.begin()->pk, entries.begin()->key);
+         }
+
+         int32_t end(uint64_t code, uint64_t scope, uint64_t table, uint64_t index) {
+            auto& tbl = get_table(code, scope, table);
+            return open(tbl, find_index(tbl, index), end_primary_key);
+         }
+
+         int32_t lower_bound(uint64_t code, uint64_t scope, uint64_t table, uint64_t index, const char* key, size_t size) {
+            return bound(code, scope, table, index, key, size, false);
+         }
+
+         int32_t upper_bound(uint64_t code, uint64_t scope, uint64_t table, uint64_t index, const char* key, size_t size) {
+            return bound(code, scope, table, index, key, size, true);
+         }
+
+         int32_t lower_bound_pk(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk) {
+            auto& tbl = get_table(code, scope, table);
+            auto itr = tbl.rows.lower_bound(pk);
+            return open(tbl, -1, itr == tbl.rows.end() ? end_primary_key : itr->first);
+         }
+
+         int32_t upper_bound_pk(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk) {
+            auto& tbl = get_table(code, scope, table);
+            auto itr = tbl.rows.upper_bound(pk);
+            return open(tbl, -1, itr == tbl.rows.end() ? end_primary_key : itr->first);
+         }
+
+         int32_t locate_to(uint64_t code, uint64_t scope, uint64_t table, uint64_t index, uint64_t pk) {
+            auto& tbl = get_table(code, scope, table);
+            const int idx = find_index(tbl, index);
+            if (!tbl.rows.count(pk))
+               fail("object to locate doesn't exist");
+            if (idx < 0)
+               return open(tbl, idx, pk);
+            // the key is taken from the row, the one of the contract can be stale if the row is modified in its cache
+            return open(tbl, idx, pk, extract_key(tbl, tbl.indexes[idx], tbl.rows[pk]));
+         }
+
+         int32_t clone(int32_t cursor) {
+            const auto copy = get_cursor(cursor);
+            cursors_[next_cursor_] = copy;
+            return next_cursor_++;
+         }
+
+         void close(int32_t cursor) {
+            if (!cursors_.erase(cursor))
+               fail("cursor doesn't exist");
+         }
+
+         uint64_t current(int32_t cursor) {
+            return get_cursor(cursor).pk;
+         }
+
+         uint64_t next(int32_t cursor) {
+            auto& cur = get_cursor(cursor);
+            if (cur.pk == end_primary_key)
+               return end_primary_key;
+            if (cur.index < 0) {
+               auto itr = cur.table->rows.upper_bound(cur.pk);
+               set_position(cur, itr == cur.table->rows.end() ? end_primary_key : itr->first);
+            } else {
+               const auto& entries = cur.table->indexes[cur.index].entries;
+               auto itr = entries.upper_bound(index_entry{cur.key, cur.pk});
+               if (itr == entries.end())
+                  set_position(cur, end_primary_key);
+               else
+                  set_position(cur, itr->pk, itr->key);
+            }
+            return cur.pk;
+         }
+
+         uint64_t prev(int32_t cursor) {
+            auto& cur = get_cursor(cursor);
+            if (cur.index < 0) {
+               const auto& rows = cur.table->rows;
+               auto itr = cur.pk == end_primary_key ? rows.end() : rows.lower_bound(cur.pk);
+               if (itr == rows.begin())
+                  return end_primary_key;
+               set_position(cur, (--itr)->first);
+            } else {
+               const auto& entries = cur.table->indexes[cur.index].entries;
+               auto itr = cur.pk == end_primary_key ? entries.end() : entries.lower_bound(index_entry{cur.key, cur.pk});
+               if (itr == entries.begin())
+                  return end_primary_key;
+               --itr;
+               set_position(cur, itr->pk, itr->key);
+            }
+            return cur.pk;
+         }
+
+         int32_t datasize(int32_t cursor) {
+            return static_cast<int32_t>(get_row(get_cursor(cursor)).data.size());
+         }
+
+         uint64_t data(int32_t cursor, char* data, size_t size) {
+            auto& cur = get_cursor(cursor);
+            const auto& row = get_row(cur);
+            memcpy(data, row.data.data(), std::min(size, row.data.size()));
+            return cur.pk;
+         }
+
+         int32_t service(int32_t cursor, char* data, size_t size) {
+            char packed[service_size];
+            pack_service(get_row(get_cursor(cursor)), packed);
+            memcpy(data, packed, size < service_size ? size : service_size);
+            return service_size;
+         }
+
+         /// Writes rows in the layout of chaindb_row_header (see capi/eosio/chaindb.h)
+         int32_t fetch(int32_t cursor, int32_t count, char* data, size_t size) {
+            auto& cur = get_cursor(cursor);
+            size_t pos = 0;
+            int32_t written = 0;
+            for (; written < count && cur.pk != end_primary_key; ++written) {
+               const auto& row = get_row(cur);
+               const size_t row_size = row_header_size + service_size + row.data.size();
+               if (pos + row_size > size) {
+                  if (written == 0)
+                     return -static_cast<int32_t>(row_size);
+                  break;
+               }
+               const int32_t service = service_size;
+               const int32_t data_size = static_cast<int32_t>(row.data.size());
+               memcpy(data + pos, &cur.pk, sizeof(cur.pk));
+               memcpy(data + pos + 8, &service, sizeof(service));
+               memcpy(data + pos + 12, &data_size, sizeof(data_size));
+               pack_service(row, data + pos + row_header_size);
+               memcpy(data + pos + row_header_size + service_size, row.data.data(), row.data.size());
+               pos += row_size;
+               next(cursor);
+            }
+            return written;
+         }
+
+         uint64_t available_primary_key(uint64_t code, uint64_t scope, uint64_t table) {
+            auto& tbl = get_table(code, scope, table);
+            if (!tbl.rows.empty() && tbl.rows.rbegin()->first >= tbl.next_pk)
+               return tbl.rows.rbegin()->first + 1;
+            return tbl.next_pk;
+         }
+
+         /// @return The RAM delta of the payer
+         int32_t insert(uint64_t code, uint64_t scope, uint64_t table, uint64_t payer, uint64_t pk, const char* data, size_t size) {
+            auto& tbl = get_table(code, scope, table);
+            if (pk == end_primary_key || pk == static_cast<uint64_t>(-2))
+               fail("invalid primary key of object");
+            if (tbl.rows.count(pk))
+               fail("object with the same primary key already exists");
+
+            row_t row;
+            row.data.assign(data, size);
+            row.payer = payer;
+            row.size = static_cast<int32_t>(size);
+            for (auto& idx: tbl.indexes)
+               check_unique(idx, extract_key(tbl, idx, row), pk);
+
+            auto& inserted = tbl.rows[pk] = std::move(row);
+            for (auto& idx: tbl.indexes)
+               idx.entries.insert(index_entry{extract_key(tbl, idx, inserted), pk});
+            tbl.next_pk = std::max(tbl.next_pk, pk + 1);
+            ram_usage_[payer] += inserted.size;
+            return inserted.size;
+         }
+
+         /// @return The RAM delta of the payer, zero payer keeps the current one
+         int32_t update(uint64_t code, uint64_t scope, uint64_t table, uint64_t payer, uint64_t pk, const char* data, size_t size) {
+            auto& tbl = get_table(code, scope, table);
+            auto itr = tbl.rows.find(pk);
+            if (itr == tbl.rows.end())
+               fail("object to update doesn't exist");
+            auto& row = itr->second;
+
+            row_t updated;
+            updated.data.assign(data, size);
+            updated.payer = payer ? payer : row.payer;
+            updated.size = static_cast<int32_t>(size);
+            updated.in_ram = row.in_ram;
+
+            std::vector<std::string> old_keys, new_keys;
+            for (auto& idx: tbl.indexes) {
+               old_keys.push_back(extract_key(tbl, idx, row));
+               new_keys.push_back(extract_key(tbl, idx, updated));
+            }
+            for (size_t i = 0; i < tbl.indexes.size(); ++i) {
+               if (!tbl.indexes[i].equal(old_keys[i], new_keys[i]))
+                  check_unique(tbl.indexes[i], new_keys[i], pk);
+            }
+            for (size_t i = 0; i < tbl.indexes.size(); ++i) {
+               tbl.indexes[i].entries.erase(index_entry{old_keys[i], pk});
+               tbl.indexes[i].entries.insert(index_entry{new_keys[i], pk});
+            }
+
+            const int32_t delta = updated.size - row.size;
+            if (row.in_ram) {
+               ram_usage_[row.payer] -= row.size;
+               ram_usage_[updated.payer] += updated.size;
+            }
+            row = std::move(updated);
+            return delta;
+         }
+
+         /// @return The RAM delta of the payer
+         int32_t remove(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk) {
+            auto& tbl = get_table(code, scope, table);
+            auto itr = tbl.rows.find(pk);
+            if (itr == tbl.rows.end())
+               fail("object to delete doesn't exist");
+            for (auto& idx: tbl.indexes)
+               idx.entries.erase(index_entry{extract_key(tbl, idx, itr->second), pk});
+            const int32_t size = itr->second.size;
+            if (itr->second.in_ram)
+               ram_usage_[itr->second.payer] -= size;
+            tbl.rows.erase(itr);
+            return -size;
+         }
+
+         /// Moves the row to RAM or to the archive, archived rows are not charged to the payer
+         void ram_state(uint64_t code, uint64_t scope, uint64_t table, uint64_t pk, bool in_ram) {
+            auto& tbl = get_table(code, scope, table);
+            auto itr = tbl.rows.find(pk);
+            if (itr == tbl.rows.end())
+               fail("object to change RAM state doesn't exist");
+            auto& row = itr->second;
+            if (row.in_ram != in_ram)
+               ram_usage_[row.payer] += in_ram ? row.size : -row.size;
+            row.in_ram = in_ram;
+         }
+
+         static uint64_t string_to_name(const std::string& str) {
+            auto char_to_value = [](char c) -> uint64_t {
+               if (c >= 'a' && c <= 'z')
+                  return (c - 'a') + 6;
+               if (c >= '1' && c <= '5')
+                  return (c - '1') + 1;
+               return 0;
+            };
+            uint64_t value = 0;
+            size_t i = 0;
+            for (; i < str.size() && i < 12; ++i)
+               value |= (char_to_value(str[i]) & 0x1f) << (64 - 5 * (i + 1));
+            if (i == 12 && str.size() > 12)
+               value |= char_to_value(str[12]) & 0x0f;
+            return value;
+         }
+
+      private:
+         // payer, size and in_ram of eosio::service_info
+         static constexpr size_t service_size    = 8 + 4 + 1;
+         static constexpr size_t row_header_size = 8 + 4 + 4;
+
+         /// JSON values, just enough for the ABI
+         struct json_value {
+            enum kind_t { null_kind, bool_kind, number_kind, string_kind, array_kind, object_kind };
+            kind_t                   kind = null_kind;
+            bool                     boolean = false;
+            std::string              str;
+            std::vector<json_value>  items;
+            std::vector<std::string> keys;   // of the object, values are in `items`
+
+            const json_value* get(const char* key) const {
+               for (size_t i = 0; i < keys.size(); ++i) {
+                  if (keys[i] == key)
+                     return &items[i];
+               }
+               return nullptr;
+            }
+
+            std::string get_string(const char* key) const {
+               auto v = get(key);
+               return v && v->kind == string_kind ? v->str : std::string();
+            }
+
+            const std::vector<json_value>& get_array(const char* key) const {
+               static const std::vector<json_value> empty;
+               auto v = get(key);
+               return v && v->kind == array_kind ? v->items : empty;
+            }
+         };
+
+         struct json_parser {
+            const char* pos;
+            const char* end;
+
+            bool parse(json_value& v) {
+               return parse_value(v, 0) && (skip_ws(), pos == end);
+            }
+
+            void skip_ws() {
+               while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+                  ++pos;
+            }
+
+            bool literal(const char* word) {
+               const size_t size = strlen(word);
+               if (size_t(end - pos) < size || memcmp(pos, word, size))
+                  return false;
+               pos += size;
+               return true;
+            }
+
+            bool parse_string(std::string& out) {
+               if (pos == end || *pos != '"')
+                  return false;
+               for (++pos; pos != end && *pos != '"'; ++pos) {
+                  if (*pos != '\\') {
+                     out += *pos;
+                     continue;
+                  }
+                  if (++pos == end)
+                     return false;
+                  switch (*pos) {
+                     case 'n': out += '\n'; break;
+                     case 't': out += '\t'; break;
+                     case 'r': out += '\r'; break;
+                     case 'b': out += '\b'; break;
+                     case 'f': out += '\f'; break;
+                     case 'u':
+                        // names of the ABI are ASCII, other characters are not decoded
+                        if (end - pos < 5)
+                           return false;
+                        out += '?';
+                        pos += 4;
+                        break;
+                     default: out += *pos; break;
+                  }
+               }
+               if (pos == end)
+                  return false;
+               ++pos;
+               return true;
+            }
+
+            bool parse_value(json_value& v, int depth) {
+               skip_ws();
+               if (pos == end || depth > 64)
+                  return false;
+               switch (*pos) {
+                  case '"':
+                     v.kind = json_value::string_kind;
+                     return parse_string(v.str);
+                  case '{':
+                     v.kind = json_value::object_kind;
+                     ++pos;
+                     skip_ws();
+                     if (pos != end && *pos == '}')
+                        return ++pos, true;
+                     for (;;) {
+                        skip_ws();
+                        v.keys.emplace_back();
+                        v.items.emplace_back();
+                        if (!parse_string(v.keys.back()))
+                           return false;
+                        skip_ws();
+                        if (pos == end || *pos++ != ':' || !parse_value(v.items.back(), depth + 1))
+                           return false;
+                        skip_ws();
+                        if (pos != end && *pos == ',') {
+                           ++pos;
+                           continue;
+                        }
+                        return pos != end && *pos++ == '}';
+                     }
+                  case '[':
+                     v.kind = json_value::array_kind;
+                     ++pos;
+                     skip_ws();
+                     if (pos != end && *pos == ']')
+                        return ++pos, true;
+                     for (;;) {
+                        v.items.emplace_back();
+                        if (!parse_value(v.items.back(), depth + 1))
+                           return false;
+                        skip_ws();
+                        if (pos != end && *pos == ',') {
+                           ++pos;
+                           continue;
+                        }
+                        return pos != end && *pos++ == ']';
+                     }
+                  case 't':
+                     v.kind = json_value::bool_kind;
+                     v.boolean = true;
+                     return literal("true");
+                  case 'f':
+                     v.kind = json_value::bool_kind;
+                     return literal("false");
+                  case 'n':
+                     return literal("null");
+                  default:
+                     v.kind = json_value::number_kind;
+                     while (pos != end && (isdigit(*pos) || *pos == '-' || *pos == '+' || *pos == '.' || *pos == 'e' || *pos == 'E'))
+                        v.str += *pos++;
+                     return !v.str.empty();
+               }
+            }
+         };
+
+         struct abi_order {
+            std::vector<std::string> path;  // the field, nested fields are separated by dots
+            bool desc = false;
+         };
+
+         struct abi_index {
+            uint64_t name = 0;
+            bool unique = false;
+            std::vector<abi_order> orders;
+            std::vector<std::string> types;  // of the order fields
+         };
+
+         struct abi_table {
+            std::string type;
+            std::vector<abi_index> indexes;  // secondary ones
+         };
+
+         struct abi_struct {
+            std::string base;
+            std::vector<std::pair<std::string, std::string>> fields;
+         };
+
+         struct abi_def {
+            std::map<std::string, std::string> typedefs;
+            std::map<std::string, abi_struct> structs;
+            std::map<std::string, std::vector<std::string>> variants;
+            std::map<uint64_t, abi_table> tables;
+
+            bool load(const json_value& root) {
+               for (const auto& t: root.get_array("types"))
+                  typedefs[t.get_string("new_type_name")] = t.get_string("type");
+               for (const auto& s: root.get_array("structs")) {
+                  auto& def = structs[s.get_string("name")];
+                  def.base = s.get_string("base");
+                  for (const auto& f: s.get_array("fields"))
+                     def.fields.emplace_back(f.get_string("name"), f.get_string("type"));
+               }
+               for (const auto& v: root.get_array("variants")) {
+                  auto& def = variants[v.get_string("name")];
+                  for (const auto& t: v.get_array("types"))
+                     def.push_back(t.str);
+               }
+               for (const auto& t: root.get_array("tables")) {
+                  auto& def = tables[string_to_name(t.get_string("name"))];
+                  def.type = t.get_string("type");
+                  for (const auto& i: t.get_array("indexes")) {
+                     if (i.get_string("name") == "primary")
+                        continue;
+                     abi_index idx;
+                     idx.name = string_to_name(i.get_string("name"));
+                     auto unique = i.get("unique");
+                     idx.unique = unique && unique->boolean;
+                     for (const auto& o: i.get_array("orders")) {
+                        abi_order order;
+                        std::string field = o.get_string("field");
+                        for (size_t start = 0;;) {
+                           const size_t dot = field.find('.', start);
+                           order.path.push_back(field.substr(start, dot - start));
+                           if (dot == std::string::npos)
+                              break;
+                           start = dot + 1;
+                        }
+                        order.desc = o.get_string("order") == "desc";
+                        idx.orders.push_back(std::move(order));
+                     }
+                     for (const auto& order: idx.orders) {
+                        std::string type = def.type;
+                        for (const auto& field: order.path) {
+                           type = field_type(type, field);
+                           if (type.empty())
+                              return false;
+                        }
+                        idx.types.push_back(type);
+                     }
+                     def.indexes.push_back(std::move(idx));
+                  }
+               }
+               return true;
+            }
+
+            std::string resolve(std::string type) const {
+               for (int i = 0; i < 32; ++i) {
+                  auto itr = typedefs.find(type);
+                  if (itr == typedefs.end())
+                     break;
+                  type = itr->second;
+               }
+               return type;
+            }
+
+            std::string field_type(const std::string& type, const std::string& field) const {
+               auto itr = structs.find(resolve(type));
+               if (itr == structs.end())
+                  return {};
+               for (const auto& f: itr->second.fields) {
+                  if (f.first == field)
+                     return f.second;
+               }
+               return itr->second.base.empty() ? std::string() : field_type(itr->second.base, field);
+            }
+
+            static bool read_varuint(const char*& pos, const char* end, uint64_t& value) {
+               value = 0;
+               for (int shift = 0; pos != end && shift < 35; shift += 7) {
+                  const uint8_t b = *pos++;
+                  value |= uint64_t(b & 0x7f) << shift;
+                  if (!(b & 0x80))
+                     return true;
+               }
+               return false;
+            }
+
+            static size_t fixed_size(const std::string& type) {
+               static const std::map<std::string, size_t> sizes = {
+                  {"bool", 1}, {"int8", 1}, {"uint8", 1}, {"int16", 2}, {"uint16", 2},
+                  {"int32", 4}, {"uint32", 4}, {"float32", 4}, {"time_point_sec", 4}, {"block_timestamp_type", 4},
+                  {"int64", 8}, {"uint64", 8}, {"float64", 8}, {"name", 8}, {"symbol", 8}, {"symbol_code", 8},
+                  {"time_point", 8}, {"int128", 16}, {"uint128", 16}, {"float128", 16}, {"asset", 16},
+                  {"checksum160", 20}, {"checksum256", 32}, {"checksum512", 64}, {"extended_asset", 24},
+               };
+               auto itr = sizes.find(type);
+               return itr == sizes.end() ? 0 : itr->second;
+            }
+
+            static bool has_suffix(const std::string& type, const char* suffix) {
+               const size_t size = strlen(suffix);
+               return type.size() > size && type.compare(type.size() - size, size, suffix) == 0;
+            }
+
+            /// Moves `pos` over a value of `type`
+            bool skip(const std::string& t, const char*& pos, const char* end, int depth = 0) const {
+               if (depth > 32)
+                  return false;
+               const std::string type = resolve(t);
+               if (has_suffix(type, "$"))
+                  return pos == end || skip(type.substr(0, type.size() - 1), pos, end, depth + 1);
+               if (has_suffix(type, "?")) {
+                  if (pos == end)
+                     return false;
+                  return !*pos++ || skip(type.substr(0, type.size() - 1), pos, end, depth + 1);
+               }
+               if (has_suffix(type, "[]")) {
+                  uint64_t count;
+                  if (!read_varuint(pos, end, count))
+                     return false;
+                  const std::string item = type.substr(0, type.size() - 2);
+                  for (uint64_t i = 0; i < count; ++i) {
+                     if (!skip(item, pos, end, depth + 1))
+                        return false;
+                  }
+                  return true;
+               }
+               if (const size_t size = fixed_size(type)) {
+                  if (size_t(end - pos) < size)
+                     return false;
+                  pos += size;
+                  return true;
+               }
+               uint64_t value;
+               if (type == "varuint32" || type == "varint32")
+                  return read_varuint(pos, end, value);
+               if (type == "string" || type == "bytes") {
+                  if (!read_varuint(pos, end, value) || uint64_t(end - pos) < value)
+                     return false;
+                  pos += value;
+                  return true;
+               }
+               if (type == "public_key" || type == "signature") {
+                  const size_t size = type == "public_key" ? 33 : 65;
+                  if (!read_varuint(pos, end, value) || size_t(end - pos) < size)
+                     return false;
+                  pos += size;
+                  return true;
+               }
+               auto variant = variants.find(type);
+               if (variant != variants.end()) {
+                  if (!read_varuint(pos, end, value) || value >= variant->second.size())
+                     return false;
+                  return skip(variant->second[value], pos, end, depth + 1);
+               }
+               auto itr = structs.find(type);
+               if (itr == structs.end())
+                  return false;
+               if (!itr->second.base.empty() && !skip(itr->second.base, pos, end, depth + 1))
+                  return false;
+               for (const auto& f: itr->second.fields) {
+                  if (!skip(f.second, pos, end, depth + 1))
+                     return false;
+               }
+               return true;
+            }
+
+            /// Finds the bytes of the field `path[i]` of the struct at `pos`, `pos` is moved over the whole struct
+            bool find(const std::string& t, const std::vector<std::string>& path, size_t i,
+                      const char*& pos, const char* end, const char*& field_begin, const char*& field_end) const {
+               auto itr = structs.find(resolve(t));
+               if (itr == structs.end())
+                  return false;
+               if (!itr->second.base.empty() && !find(itr->second.base, path, i, pos, end, field_begin, field_end))
+                  return false;
+               for (const auto& f: itr->second.fields) {
+                  const char* start = pos;
+                  if (f.first != path[i]) {
+                     if (!skip(f.second, pos, end))
+                        return false;
+                  } else if (i + 1 == path.size()) {
+                     if (!skip(f.second, pos, end))
+                        return false;
+                     field_begin = start;
+                     field_end = pos;
+                  } else if (!find(f.second, path, i + 1, pos, end, field_begin, field_end)) {
+                     return false;
+                  }
+               }
+               return true;
+            }
+
+            template<typename T>
+            static T load(const char* pos) {
+               T value;
+               memcpy(&value, pos, sizeof(T));
+               return value;
+            }
+
+            template<typename T>
+            static int compare_numbers(const T& a, const T& b) {
+               return a < b ? -1 : (b < a ? 1 : 0);
+            }
+
+            static int compare_bytes(const char* a, size_t a_size, const char* b, size_t b_size) {
+               const int r = memcmp(a, b, std::min(a_size, b_size));
+               return r ? (r < 0 ? -1 : 1) : compare_numbers(a_size, b_size);
+            }
+
+            /// Compares two packed values of `type`, `a` and `b` are moved over the values
+            int compare(const std::string& t, const char*& a, const char* a_end, const char*& b, const char* b_end, int depth = 0) const {
+               const std::string type = resolve(t);
+               const char* a_start = a;
+               const char* b_start = b;
+               if (!skip(type, a, a_end) || !skip(type, b, b_end))
+                  return a == a_end ? 0 : 1;  // an incomplete value of a partial key, equal to the rest
+
+               const size_t size = fixed_size(type);
+               if (type == "int8")    return compare_numbers(load<int8_t>(a_start),  load<int8_t>(b_start));
+               if (type == "int16")   return compare_numbers(load<int16_t>(a_start), load<int16_t>(b_start));
+               if (type == "int32")   return compare_numbers(load<int32_t>(a_start), load<int32_t>(b_start));
+               if (type == "int64" || type == "time_point")
+                  return compare_numbers(load<int64_t>(a_start), load<int64_t>(b_start));
+               if (type == "float32") return compare_numbers(load<float>(a_start),   load<float>(b_start));
+               if (type == "float64") return compare_numbers(load<double>(a_start),  load<double>(b_start));
+               if (type == "int128" || type == "uint128") {
+                  const int hi = type == "int128" ? compare_numbers(load<int64_t>(a_start + 8), load<int64_t>(b_start + 8))
+                                                  : compare_numbers(load<uint64_t>(a_start + 8), load<uint64_t>(b_start + 8));
+                  return hi ? hi : compare_numbers(load<uint64_t>(a_start), load<uint64_t>(b_start));
+               }
+               if (type == "asset") {
+                  const int amount = compare_numbers(load<int64_t>(a_start), load<int64_t>(b_start));
+                  return amount ? amount : compare_numbers(load<uint64_t>(a_start + 8), load<uint64_t>(b_start + 8));
+               }
+               if (size == 1 || size == 2 || size == 4 || size == 8) {
+                  // unsigned integers, names and symbols, little-endian
+                  for (size_t i = size; i-- > 0;) {
+                     const int r = compare_numbers(uint8_t(a_start[i]), uint8_t(b_start[i]));
+                     if (r)
+                        return r;
+                  }
+                  return 0;
+               }
+               uint64_t a_size, b_size;
+               if (type == "varuint32") {
+                  read_varuint(a_start, a_end, a_size);
+                  read_varuint(b_start, b_end, b_size);
+                  return compare_numbers(a_size, b_size);
+               }
+               if (type == "string" || type == "bytes") {
+                  read_varuint(a_start, a_end, a_size);
+                  read_varuint(b_start, b_end, b_size);
+                  return compare_bytes(a_start, a_size, b_start, b_size);
+               }
+               auto itr = structs.find(type);
+               if (itr != structs.end() && depth < 32) {
+                  const char* x = a_start;
+                  const char* y = b_start;
+                  if (!itr->second.base.empty()) {
+                     if (const int r = compare(itr->second.base, x, a_end, y, b_end, depth + 1))
+                        return r;
+                  }
+                  for (const auto& f: itr->second.fields) {
+                     if (const int r = compare(f.second, x, a_end, y, b_end, depth + 1))
+                        return r;
+                  }
+                  return 0;
+               }
+               // the other types are ordered by their packed bytes
+               return compare_bytes(a_start, a - a_start, b_start, b - b_start);
+            }
+         };
+
+         struct index_entry {
+            std::string key;  // packed values of the order fields
+            uint64_t    pk;
+         };
+
+         struct key_less {
+            const abi_def*   abi;
+            const abi_index* def;
+
+            int compare(const std::string& a, const std::string& b) const {
+               const char* x = a.data();
+               const char* y = b.data();
+               for (size_t i = 0; i < def->types.size(); ++i) {
+                  if (x == a.data() + a.size() || y == b.data() + b.size())
+                     break;  // a partial key
+                  const int r = abi->compare(def->types[i], x, a.data() + a.size(), y, b.data() + b.size());
+                  if (r)
+                     return def->orders[i].desc ? -r : r;
+               }
+               return 0;
+            }
+
+            bool operator()(const index_entry& a, const index_entry& b) const {
+               const int r = compare(a.key, b.key);
+               return r ? r < 0 : a.pk < b.pk;
+            }
+         };
+
+         struct secondary_index {
+            secondary_index(const abi_def* abi, const abi_index* def)
+               : def(def), entries(key_less{abi, def}) {}
+
+            bool equal(const std::string& a, const std::string& b) const {
+               return entries.key_comp().compare(a, b) == 0;
+            }
+
+            const abi_index* def;
+            std::set<index_entry, key_less> entries;
+         };
+
+         struct row_t {
+            std::string data;
+            uint64_t    payer = 0;
+            int32_t     size = 0;
+            bool        in_ram = true;
+         };
+
+         struct table_t {
+            const abi_def*               abi = nullptr;
+            const abi_table*             def = nullptr;
+            std::map<uint64_t, row_t>    rows;
+            std::vector<secondary_index> indexes;
+            uint64_t                     next_pk = 0;
+         };
+
+         struct cursor_t {
+            table_t*    table;
+            int         index;  // -1 for the primary index
+            uint64_t    pk;
+            std::string key;    // of the secondary index
+         };
+
+         [[noreturn]] void fail(const char* msg) const {
+            fail_(msg);
+            abort();
+         }
+
+         table_t& get_table(uint64_t code, uint64_t scope, uint64_t table) {
+            auto itr = tables_.find(std::make_tuple(code, scope, table));
+            if (itr != tables_.end())
+               return itr->second;
+
+            auto& tbl = tables_[std::make_tuple(code, scope, table)];
+            auto abi = abis_.find(code);
+            if (abi != abis_.end()) {
+               auto def = abi->second.tables.find(table);
+               if (def != abi->second.tables.end()) {
+                  tbl.abi = &abi->second;
+                  tbl.def = &def->second;
+                  tbl.indexes.reserve(def->second.indexes.size());
+                  for (const auto& idx: def->second.indexes)
+                     tbl.indexes.emplace_back(tbl.abi, &idx);
+               }
+            }
+            return tbl;
+         }
+
+         int find_index(const table_t& tbl, uint64_t index) const {
+            static const uint64_t primary = string_to_name("primary");
+            if (index == primary)
+               return -1;
+            for (size_t i = 0; i < tbl.indexes.size(); ++i) {
+               if (tbl.indexes[i].def->name == index)
+                  return static_cast<int>(i);
+            }
+            fail(tbl.def ? "index doesn't exist in the ABI of the table" : "table doesn't exist in the ABI of the contract");
+         }
+
+         std::string extract_key(const table_t& tbl, const secondary_index& idx, const row_t& row) const {
+            std::string key;
+            for (const auto& order: idx.def->orders) {
+               const char* pos = row.data.data();
+               const char* begin = nullptr;
+               const char* end = nullptr;
+               if (!tbl.abi->find(tbl.def->type, order.path, 0, pos, row.data.data() + row.data.size(), begin, end) || !begin)
+                  fail("unable to extract the key of the index from the object");
+               key.append(begin, end);
+            }
+            return key;
+         }
+
+         void check_unique(const secondary_index& idx, const std::string& key, uint64_t pk) const {
+            if (!idx.def->unique)
+               return;
+            auto itr = idx.entries.lower_bound(index_entry{key, 0});
+            if (itr != idx.entries.end() && itr->pk != pk && idx.equal(itr->key, key))
+               fail("unique key of the index already exists");
+         }
+
+         int32_t bound(uint64_t code, uint64_t scope, uint64_t table, uint64_t index, const char* key, size_t size, bool upper) {
+            auto& tbl = get_table(code, scope, table);
+            const int idx = find_index(tbl, index);
+            if (idx < 0) {
+               if (size != sizeof(uint64_t))
+                  fail("invalid size of the primary key");
+               uint64_t pk;
+               memcpy(&pk, key, sizeof(pk));
+               return upper ? upper_bound_pk(code, scope, table, pk) : lower_bound_pk(code, scope, table, pk);
+            }
+            const auto& entries = tbl.indexes[idx].entries;
+            // the key with pk 0 is before all entries with the key, the one with the end pk is after them
+            const index_entry probe{std::string(key, size), upper ? end_primary_key : 0};
+            auto itr = entries.lower_bound(probe);
+            if (upper) {
+               while (itr != entries.end() && tbl.indexes[idx].equal(itr->key, probe.key))
+                  ++itr;
+            }
+            if (itr == entries.end())
+               return open(tbl, idx, end_primary_key);
+            return open(tbl, idx, itr->pk, itr->key);
+         }
+
+         int32_t open(table_t& tbl, int index, uint64_t pk, std::string key = {}) {
+            cursors_[next_cursor_] = cursor_t{&tbl, index, pk, std::move(key)};
+            return next_cursor_++;
+         }
+
+         cursor_t& get_cursor(int32_t cursor) {
+            auto itr = cursors_.find(cursor);
+            if (itr == cursors_.end())
+               fail("cursor doesn't exist");
+            return itr->second;
+         }
+
+         void set_position(cursor_t& cur, uint64_t pk, const std::string& key = {}) {
+            cur.pk = pk;
+            cur.key = key;
+         }
+
+         const row_t& get_row(const cursor_t& cur) const {
+            if (cur.pk == end_primary_key)
+               fail("cursor points to the end of the table");
+            auto itr = cur.table->rows.find(cur.pk);
+            if (itr == cur.table->rows.end())
+               fail("cursor points to a deleted object");
+            return itr->second;
+         }
+
+         static void pack_service(const row_t& row, char* data) {
+            memcpy(data, &row.payer, 8);
+            memcpy(data + 8, &row.size, 4);
+            data[12] = row.in_ram;
+         }
+
+         fail_callback fail_;
+         std::map<uint64_t, abi_def> abis_;
+         std::map<std::tuple<uint64_t, uint64_t, uint64_t>, table_t> tables_;
+         std::map<int32_t, cursor_t> cursors_;
+         std::map<uint64_t, int64_t> ram_usage_;
+         int32_t next_cursor_ = 1;
+   };
+
+}} // ns eosio::native
@@ -27,4 +27,8 @@ extern "C" {
    void __reset_env();
    void _prints_l(const char* cstr, uint32_t len, uint8_t which);
    void _prints(const char* cstr, uint8_t which);
+   size_t _current_memory();
+   uint64_t _steady_clock_ns();
+   bool __run_test_in_worker(const char* name, void (*test)());
+   void __wait_test_workers();
 }
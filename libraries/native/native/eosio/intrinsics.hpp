@@ -3,6 +3,8 @@
 
 #pragma once
 
+extern "C" uint64_t _steady_clock_ns();
+
 namespace eosio { namespace native {
    
    class intrinsics {
@@ -25,9 +27,60 @@ namespace eosio { namespace native {
 
          template <intrinsic_name IN, typename... Args>
          auto call(Args... args) -> decltype(std::get<IN>(intrinsics::get().funcs)(args...)) {
+            ++call_counts[IN];
+            if (tracing) {
+               trace_scope trace(trace_stats[IN], args...);
+               return std::get<IN>(intrinsics::get().funcs)(args...);
+            }
             return std::get<IN>(intrinsics::get().funcs)(args...); 
          }
 
+         // number of calls of each intrinsic, used by the benchmarks (see bench.hpp)
+         uint64_t call_counts[INTRINSICS_SIZE] = {};
+
+         struct call_stats {
+            uint64_t calls   = 0;
+            uint64_t bytes   = 0;  // sum of the sizes of the buffers passed as (pointer, size)
+            uint64_t time_ns = 0;  // includes the nested intrinsic calls
+         };
+
+         // tracing of the calls, it is enabled by --trace-intrinsics of the executable
+         // and the report is printed at exit (see _wrap_main in crt.cpp)
+         bool       tracing = false;
+         call_stats trace_stats[INTRINSICS_SIZE] = {};
+
+         static const char* get_name(intrinsic_name in) {
+            static const char* names[] = { INTRINSICS(GET_NAME) "" };
+            return names[in];
+         }
+
+      private:
+         struct trace_scope {
+            template <typename... Args>
+            trace_scope(call_stats& stats, Args... args) : stats(stats), start_ns(_steady_clock_ns()) {
+               (add_bytes(args), ...);
+               ++stats.calls;
+            }
+            ~trace_scope() {
+               stats.time_ns += _steady_clock_ns() - start_ns;
+            }
+
+            // an integer after a pointer is the size of the buffer
+            template <typename T>
+            void add_bytes(T arg) {
+               if constexpr (std::is_integral<T>::value) {
+                  if (after_pointer && arg > 0)
+                     stats.bytes += arg;
+               }
+               after_pointer = std::is_pointer<T>::value;
+            }
+
+            call_stats& stats;
+            uint64_t    start_ns;
+            bool        after_pointer = false;
+         };
+
+      public:
          template <intrinsic_name IN, typename F>
          static void set_intrinsic(F&& func) {
             auto& f = std::get<IN>(intrinsics::get().funcs);
@@ -10,8 +10,58 @@
 #include <eosio/transaction.h>
 #include <eosio/types.h>
 
+#include <eosio/name.hpp>
+
 #include <type_traits>
 
+// chaindb imports, with the same types as their declarations in eosio/multi_index.hpp
+extern "C" {
+   int32_t chaindb_begin(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw);
+   int32_t chaindb_end(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw);
+   int32_t chaindb_lower_bound(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw, void* key, int32_t);
+   int32_t chaindb_lower_bound_pk(eosio::name::raw, uint64_t, eosio::name::raw, uint64_t);
+   int32_t chaindb_upper_bound(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw, void* key, int32_t);
+   int32_t chaindb_upper_bound_pk(eosio::name::raw, uint64_t, eosio::name::raw, uint64_t);
+   int32_t chaindb_locate_to(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw, uint64_t, void* key, int32_t);
+   int32_t chaindb_clone(eosio::name::raw, int32_t);
+   void chaindb_close(eosio::name::raw, int32_t);
+   uint64_t chaindb_current(eosio::name::raw, int32_t);
+   uint64_t chaindb_next(eosio::name::raw, int32_t);
+   uint64_t chaindb_prev(eosio::name::raw, int32_t);
+   int32_t chaindb_datasize(eosio::name::raw, int32_t);
+   uint64_t chaindb_data(eosio::name::raw, int32_t, void* data, int32_t size);
+   int32_t chaindb_service(eosio::name::raw, int32_t, void* data, int32_t size);
+   int32_t chaindb_fetch(eosio::name::raw, int32_t, int32_t count, void* data, int32_t size);
+   uint64_t chaindb_available_primary_key(eosio::name::raw, uint64_t, eosio::name::raw);
+   int32_t chaindb_insert(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw, uint64_t, void* data, int32_t);
+   int32_t chaindb_update(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw, uint64_t, void* data, int32_t);
+   int32_t chaindb_delete(eosio::name::raw, uint64_t, eosio::name::raw, eosio::name::raw, uint64_t);
+   void chaindb_ram_state(eosio::name::raw, uint64_t, eosio::name::raw, uint64_t, int32_t);
+}
+
+#define CHAINDB_INTRINSICS(intrinsic_macro) \
+intrinsic_macro(chaindb_begin) \
+intrinsic_macro(chaindb_end) \
+intrinsic_macro(chaindb_lower_bound) \
+intrinsic_macro(chaindb_lower_bound_pk) \
+intrinsic_macro(chaindb_upper_bound) \
+intrinsic_macro(chaindb_upper_bound_pk) \
+intrinsic_macro(chaindb_locate_to) \
+intrinsic_macro(chaindb_clone) \
+intrinsic_macro(chaindb_close) \
+intrinsic_macro(chaindb_current) \
+intrinsic_macro(chaindb_next) \
+intrinsic_macro(chaindb_prev) \
+intrinsic_macro(chaindb_datasize) \
+intrinsic_macro(chaindb_data) \
+intrinsic_macro(chaindb_service) \
+intrinsic_macro(chaindb_fetch) \
+intrinsic_macro(chaindb_available_primary_key) \
+intrinsic_macro(chaindb_insert) \
+intrinsic_macro(chaindb_update) \
+intrinsic_macro(chaindb_delete) \
+intrinsic_macro(chaindb_ram_state)
+
 namespace eosio { namespace native {
    template <typename... Args, size_t... Is>
    auto get_args_full(std::index_sequence<Is...>) {
@@ -90,11 +140,15 @@ intrinsic_macro(send_context_free_inline) \
 intrinsic_macro(send_deferred) \
 intrinsic_macro(cancel_deferred) \
 intrinsic_macro(send_nested) \
-intrinsic_macro(get_context_free_data) 
+intrinsic_macro(get_context_free_data) \
+CHAINDB_INTRINSICS(intrinsic_macro)
 
 #define CREATE_ENUM(name) \
    name,
 
+#define GET_NAME(name) \
+   #name,
+
 #define GENERATE_TYPE_MAPPING(name) \
    struct __ ## name ## _types { \
       using deduced_full_ts = decltype(eosio::native::get_args_full(::name)); \
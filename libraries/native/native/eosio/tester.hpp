@@ -13,6 +13,7 @@ inline void silence_output(bool t) {
    ___disable_output = t;
 }
 inline bool has_failed() {
+   __wait_test_workers();
    return ___has_failed;
 }
 
@@ -101,16 +102,19 @@ inline bool expect_print(bool check, const std::string& li, const char (&expecte
 #define REQUIRE_EQUAL(X, Y) \
    eosio::check(X == Y, std::string(std::string("REQUIRE_EQUAL failed (")+#X+" != "+#Y+") {"+__FILE__+":"+std::to_string(__LINE__)+"}").c_str());
 
+// With -j <workers> on the command line the tests run concurrently in forked workers (see crt.cpp)
 #define EOSIO_TEST(X) \
-   int X ## _ret = setjmp(*___env_ptr); \
-   if ( X ## _ret == 0 ) \
-      X(); \
-   else { \
-      bool ___original_disable_output = ___disable_output; \
-      silence_output(false); \
-      eosio::print("\033[1;37m", #X, " \033[0;37munit test \033[1;31mfailed\033[0m (aborted)\n"); \
-      ___has_failed = true; \
-      silence_output(___original_disable_output); \
+   if ( !__run_test_in_worker(#X, &X) ) { \
+      int X ## _ret = setjmp(*___env_ptr); \
+      if ( X ## _ret == 0 ) \
+         X(); \
+      else { \
+         bool ___original_disable_output = ___disable_output; \
+         silence_output(false); \
+         eosio::print("\033[1;37m", #X, " \033[0;37munit test \033[1;31mfailed\033[0m (aborted)\n"); \
+         ___has_failed = true; \
+         silence_output(___original_disable_output); \
+      } \
    }
 
 #define EOSIO_TEST_BEGIN(X) \
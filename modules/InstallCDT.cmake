@@ -72,6 +72,8 @@ eosio_clang_install(wasm-ld)
 eosio_tool_install_and_symlink(eosio-pp eosio-pp)
 eosio_tool_install_and_symlink(eosio-wast2wasm eosio-wast2wasm)
 eosio_tool_install_and_symlink(eosio-wasm2wast eosio-wasm2wast)
+eosio_tool_install_and_symlink(eosio-action-cost eosio-action-cost)
+eosio_tool_install_and_symlink(eosio-wasm2c eosio-wasm2c)
 eosio_tool_install_and_symlink(eosio-cc eosio-cc)
 eosio_tool_install_and_symlink(cyberway-cpp cyberway-cpp)
 eosio_tool_install_and_symlink(eosio-ld eosio-ld)
@@ -83,6 +85,11 @@ eosio_clang_install(../lib/LLVMEosioApply${CMAKE_SHARED_LIBRARY_SUFFIX})
 eosio_clang_install(../lib/LLVMEosioSoftfloat${CMAKE_SHARED_LIBRARY_SUFFIX})
 eosio_clang_install(../lib/eosio_plugin${CMAKE_SHARED_LIBRARY_SUFFIX})
 
+# host runtime of contracts compiled by eosio-wasm2c, installed with the libraries
+add_custom_command( TARGET EosioTools POST_BUILD COMMAND mkdir -p ${CMAKE_BINARY_DIR}/lib ${CMAKE_BINARY_DIR}/include/wasm2c )
+add_custom_command( TARGET EosioTools POST_BUILD COMMAND ${CMAKE_COMMAND} -E copy ${CMAKE_BINARY_DIR}/tools/lib/libeosio_wasm2c.a ${CMAKE_BINARY_DIR}/lib/ )
+add_custom_command( TARGET EosioTools POST_BUILD COMMAND ${CMAKE_COMMAND} -E copy ${CMAKE_BINARY_DIR}/tools/include/wasm2c/wasm-rt.h ${CMAKE_BINARY_DIR}/include/wasm2c/ )
+
 eosio_libraries_install()
 
 eosio_cmake_install_and_symlink(cyberway.cdt-config.cmake cyberway.cdt-config.cmake)
@@ -69,6 +69,49 @@ BOOST_FIXTURE_TEST_CASE( simple_tests, tester ) try {
 
 } FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE( dispatch_table_tests, tester ) try {
+   create_accounts( { N(test), N(eosio.token), N(someone), N(other) } );
+   produce_block();
+
+   set_code( N(eosio.token), contracts::transfer_wasm() );
+   set_abi(  N(eosio.token),  contracts::transfer_abi().data() );
+
+   set_code( N(someone), contracts::transfer_wasm() );
+   set_abi(  N(someone),  contracts::transfer_abi().data() );
+
+   set_code( N(test), contracts::dispatch_table_wasm() );
+   set_abi( N(test),  contracts::dispatch_table_abi().data() );
+   produce_blocks();
+
+   push_action(N(test), N(test1), N(test), mvo() ("nm", "bucky"));
+   BOOST_CHECK_EXCEPTION( push_action(N(test), N(test1), N(test), mvo() ("nm", "notbucky")),
+                          eosio_assert_message_exception, eosio_assert_message_is("not bucky") );
+
+   push_action(N(test), N(test2), N(test), mvo() ("arg0", 33) ("arg1", "some string"));
+   BOOST_CHECK_EXCEPTION( push_action(N(test), N(test2), N(test), mvo() ("arg0", 30) ("arg1", "some string")),
+                          eosio_assert_message_exception, eosio_assert_message_is("33 does not match") );
+
+   // the handler of eosio.token::transfer
+   push_action(N(test), N(sendtransfer), N(test), mvo() ("memo", "memo"));
+   BOOST_CHECK_EXCEPTION( push_action(N(test), N(sendtransfer), N(test), mvo() ("memo", "fail")),
+                          eosio_assert_message_exception, eosio_assert_message_is("on_transfer failed") );
+
+   // the handler of *::transfer2
+   push_action(N(test), N(sendtrans2), N(test), mvo() ("memo", "memo"));
+   BOOST_CHECK_EXCEPTION( push_action(N(test), N(sendtrans2), N(test), mvo() ("memo", "fail")),
+                          eosio_assert_message_exception, eosio_assert_message_is("on_transfer2 failed") );
+
+   // a notification without a handler is ignored
+   push_action(N(test), N(sendtrans3), N(test), mvo() ("memo", "fail"));
+
+   // an unknown action fails, it isn't in the ABI so the transaction is built by hand
+   signed_transaction trx;
+   trx.actions.emplace_back( std::vector<permission_level>{{N(test), config::active_name}}, N(test), N(unknown), bytes() );
+   set_transaction_headers(trx);
+   trx.sign( get_private_key(N(test), "active"), control->get_chain_id() );
+   BOOST_CHECK_EXCEPTION( push_transaction(trx), eosio_assert_code_exception, eosio_assert_code_is(1) );
+} FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE( simple_eosio_tests, tester ) try {
    set_code( N(eosio), contracts::simple_wasm() );
    set_abi( N(eosio),  contracts::simple_wrong_abi().data() );
@@ -35,3 +35,50 @@ BOOST_FIXTURE_TEST_CASE( malloc_tests, tester ) try {
                           eosio_assert_message_is("failed to allocate pages") );
                           */
 } FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( size_class_malloc_tests, tester ) try {
+   create_accounts( { N(test) } );
+   produce_block();
+
+   set_code( N(test), contracts::size_class_malloc_tests_wasm() );
+   set_abi( N(test), contracts::size_class_malloc_tests_abi().data() );
+   produce_blocks();
+
+   push_action(N(test), N(reallocgrow), N(test), {});
+   push_action(N(test), N(calloczero), N(test), {});
+   push_action(N(test), N(freereuse), N(test), {});
+   push_action(N(test), N(powoftwo), N(test), {});
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( malloc_bench, tester ) try {
+   const std::vector<std::pair<account_name, const char*>> allocators = {
+      { N(dsm),       "non-freeing" },
+      { N(freeing),   "freeing" },
+      { N(sizeclass), "size-class" } };
+
+   create_accounts( { N(dsm), N(freeing), N(sizeclass) } );
+   produce_block();
+
+   set_code( N(dsm), contracts::malloc_bench_wasm() );
+   set_abi( N(dsm), contracts::malloc_bench_abi().data() );
+   set_code( N(freeing), contracts::old_malloc_bench_wasm() );
+   set_abi( N(freeing), contracts::old_malloc_bench_abi().data() );
+   set_code( N(sizeclass), contracts::size_class_malloc_bench_wasm() );
+   set_abi( N(sizeclass), contracts::size_class_malloc_bench_abi().data() );
+   produce_blocks();
+
+   const std::vector<std::pair<action_name, mvo>> traces = {
+      { N(vectors), mvo()("rounds", 2000) },
+      { N(maps),    mvo()("count", 8000) },
+      { N(mixed),   mvo()("count", 30000)("window", 512) } };
+
+   for (const auto& trace: traces) {
+      for (const auto& allocator: allocators) {
+         auto result = push_action(allocator.first, trace.first, allocator.first, trace.second);
+         BOOST_REQUIRE(result);
+         BOOST_TEST_MESSAGE( name(trace.first).to_string() << ", " << allocator.second << " malloc: "
+                             << result->elapsed.count() << " us" );
+         produce_block();
+      }
+   }
+} FC_LOG_AND_RETHROW() }
@@ -0,0 +1,113 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+using std::string;
+using std::vector;
+
+static vector<char> action_data;
+
+static void set_action_data(const vector<char>& data) {
+   action_data = data;
+   intrinsics::set_intrinsic<intrinsics::action_data_size>([]() {
+      return (uint32_t)action_data.size();
+   });
+   intrinsics::set_intrinsic<intrinsics::read_action_data>([](void* m, uint32_t len) {
+      len = std::min<uint32_t>(len, action_data.size());
+      memcpy(m, action_data.data(), len);
+      return len;
+   });
+}
+
+class test_contract : public contract {
+   public:
+      using contract::contract;
+
+      void transfer(name from, uint64_t amount, string memo) {
+         args = std::make_tuple(from, amount, memo);
+      }
+      void batch(bytes_view items) {
+         batch_items = items;
+      }
+
+      static std::tuple<name, uint64_t, string> args;
+      static bytes_view                          batch_items;
+};
+
+std::tuple<name, uint64_t, string> test_contract::args;
+bytes_view                          test_contract::batch_items;
+
+// Definitions in `eosio.cdt/libraries/eosio/action.hpp`
+EOSIO_TEST_BEGIN(action_data_reserve_test)
+   const auto data = pack(std::make_tuple("alice"_n, uint64_t{42}, string("memo")));
+   set_action_data(data);
+
+   const auto view = get_action_data();
+   CHECK_EQUAL( view.data() == internal_use_do_not_use::action_data_reserve, true )
+   CHECK_EQUAL( view == bytes_view{data}, true )
+
+   const auto args = unpack_action_data<std::tuple<name, uint64_t, string>>();
+   CHECK_EQUAL( std::get<0>(args), "alice"_n )
+   CHECK_EQUAL( std::get<1>(args), 42 )
+   CHECK_EQUAL( std::get<2>(args), "memo" )
+
+   set_action_data({});
+   CHECK_EQUAL( get_action_data().empty(), true )
+EOSIO_TEST_END
+
+// Larger data is read into a heap buffer, which is reused by the following actions
+EOSIO_TEST_BEGIN(action_data_grow_test)
+   const vector<char> large(EOSIO_ACTION_DATA_RESERVE * 3, 'x');
+   set_action_data(pack(large));
+
+   const auto view = get_action_data();
+   CHECK_EQUAL( view.data() != internal_use_do_not_use::action_data_reserve, true )
+   CHECK_EQUAL( view == bytes_view{action_data}, true )
+   CHECK_EQUAL( unpack_action_data<vector<char>>() == large, true )
+
+   set_action_data(pack(vector<char>(EOSIO_ACTION_DATA_RESERVE * 2, 'y')));
+   CHECK_EQUAL( get_action_data().data() == view.data(), true )
+   CHECK_EQUAL( (get_action_data() == bytes_view{action_data}), true )
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/dispatcher.hpp`
+EOSIO_TEST_BEGIN(execute_action_test)
+   set_action_data(pack(std::make_tuple("bob"_n, uint64_t{7}, string("hi"))));
+   execute_action("test"_n, "test"_n, &test_contract::transfer);
+   CHECK_EQUAL( std::get<0>(test_contract::args), "bob"_n )
+   CHECK_EQUAL( std::get<1>(test_contract::args), 7 )
+   CHECK_EQUAL( std::get<2>(test_contract::args), "hi" )
+
+   // the view points into the arena and is valid after the handler returns
+   const vector<char> items(EOSIO_ACTION_DATA_RESERVE + 100, 'z');
+   set_action_data(pack(items));
+   execute_action("test"_n, "test"_n, &test_contract::batch);
+   const auto data = get_action_data();
+   CHECK_EQUAL( test_contract::batch_items.data() > data.data(), true )
+   CHECK_EQUAL( test_contract::batch_items.data() + items.size() == data.end(), true )
+   CHECK_EQUAL( test_contract::batch_items == bytes_view{items}, true )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(action_data_reserve_test);
+   EOSIO_TEST(action_data_grow_test);
+   EOSIO_TEST(execute_action_test);
+   return has_failed();
+}
@@ -0,0 +1,52 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/bench.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+static constexpr symbol cyber_symbol = symbol("CYBER", 4);
+
+EOSIO_BENCH_BEGIN(asset_add_bench)
+   asset sum(0, cyber_symbol);
+   const asset delta(1, cyber_symbol);
+   EOSIO_BENCH_LOOP {
+      sum += delta;
+      do_not_optimize(sum.amount);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(asset_multiply_bench)
+   const asset a(12345, cyber_symbol);
+   EOSIO_BENCH_LOOP {
+      do_not_optimize((a * 3).amount);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(asset_to_string_bench)
+   const asset a(123456789, cyber_symbol);
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(a.to_string());
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(symbol_from_string_bench)
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(symbol(std::string_view("CYBER"), 4).raw());
+   }
+EOSIO_BENCH_END
+
+int main(int argc, char* argv[]) {
+   if (!parse_bench_args(argc, argv))
+      return -1;
+
+   EOSIO_BENCH(asset_add_bench);
+   EOSIO_BENCH(asset_multiply_bench);
+   EOSIO_BENCH(asset_to_string_bench);
+   EOSIO_BENCH(symbol_from_string_bench);
+   return has_failed();
+}
@@ -0,0 +1,112 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <eosio/tester.hpp>
+#include <eosio/bytes_view.hpp>
+#include <eosio/datastream.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+// Definitions in `eosio.cdt/libraries/eosio/bytes_view.hpp`
+EOSIO_TEST_BEGIN(bytes_view_test)
+   const vector<char> bytes{'a', 'b', 'c', 'd'};
+   const bytes_view view{bytes};
+
+   CHECK_EQUAL( view.size(), 4 )
+   CHECK_EQUAL( view.data() == bytes.data(), true )
+   CHECK_EQUAL( view[2], 'c' )
+   CHECK_EQUAL( view.to_vector() == bytes, true )
+   CHECK_EQUAL( (view == bytes_view{bytes.data(), 4}), true )
+   CHECK_EQUAL( (view != bytes_view{bytes.data(), 3}), true )
+   CHECK_EQUAL( bytes_view{}.empty(), true )
+   CHECK_EQUAL( (bytes_view{} == bytes_view{bytes.data(), 0}), true )
+EOSIO_TEST_END
+
+// Views are serialized in the same way as the owning types
+EOSIO_TEST_BEGIN(bytes_view_pack_test)
+   const vector<char> bytes{'a', 'b', 'c', 'd'};
+   const string str{"memo"};
+
+   CHECK_EQUAL( pack(bytes_view{bytes}) == pack(bytes), true )
+   CHECK_EQUAL( pack(string_view{str}) == pack(str), true )
+   CHECK_EQUAL( pack(bytes_view{}) == pack(vector<char>{}), true )
+   CHECK_EQUAL( pack(string_view{}) == pack(string{}), true )
+   CHECK_EQUAL( pack_size(bytes_view{bytes}), pack_size(bytes) )
+   CHECK_EQUAL( pack_size(string_view{str}), pack_size(str) )
+EOSIO_TEST_END
+
+// Unpacked views point into the buffer of the stream
+EOSIO_TEST_BEGIN(bytes_view_unpack_test)
+   const vector<char> payload(1000, 'x');
+   const string memo(300, 'm');
+   const auto buffer = pack(std::make_tuple(uint64_t{42}, payload, memo));
+
+   datastream<const char*> ds{buffer.data(), buffer.size()};
+   uint64_t id;
+   bytes_view payload_view;
+   string_view memo_view;
+   ds >> id >> payload_view >> memo_view;
+
+   CHECK_EQUAL( id, 42 )
+   CHECK_EQUAL( ds.remaining(), 0 )
+   CHECK_EQUAL( payload_view.to_vector() == payload, true )
+   CHECK_EQUAL( string(memo_view) == memo, true )
+
+   // 8 bytes of id, 2 bytes of varuint32 size prefixes
+   CHECK_EQUAL( payload_view.data() == buffer.data() + 8 + 2, true )
+   CHECK_EQUAL( memo_view.data() == payload_view.data() + payload.size() + 2, true )
+
+   // the same as the owning types
+   const auto views = unpack<std::tuple<uint64_t, bytes_view, string_view>>(buffer);
+   const auto owned = unpack<std::tuple<uint64_t, vector<char>, string>>(buffer);
+   CHECK_EQUAL( std::get<1>(views).to_vector() == std::get<1>(owned), true )
+   CHECK_EQUAL( string(std::get<2>(views)) == std::get<2>(owned), true )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(bytes_view_bounds_test)
+   // the size prefix is larger than the rest of the buffer
+   const vector<char> buffer{10, 'a', 'b', 'c'};
+
+   CHECK_ASSERT( "read", ([&]() {
+      datastream<const char*> ds{buffer.data(), buffer.size()};
+      bytes_view v;
+      ds >> v;
+   }) )
+   CHECK_ASSERT( "read", ([&]() {
+      datastream<const char*> ds{buffer.data(), buffer.size()};
+      string_view v;
+      ds >> v;
+   }) )
+
+   const vector<char> exact{3, 'a', 'b', 'c'};
+   datastream<const char*> ds{exact.data(), exact.size()};
+   string_view v;
+   ds >> v;
+   CHECK_EQUAL( v == "abc", true )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(bytes_view_test);
+   EOSIO_TEST(bytes_view_pack_test);
+   EOSIO_TEST(bytes_view_unpack_test);
+   EOSIO_TEST(bytes_view_bounds_test);
+   return has_failed();
+}
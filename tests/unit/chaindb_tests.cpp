@@ -0,0 +1,244 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio/tester.hpp>
+#include <eosio/chaindb.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+static constexpr auto code_account = name::raw("contract"_n);
+static constexpr auto alice    = name::raw("alice"_n);
+static constexpr auto bob      = name::raw("bob"_n);
+static constexpr auto carol    = name::raw("carol"_n);
+
+struct balance {
+   uint64_t id     = 0;
+   uint64_t amount = 0;
+   name     owner;
+
+   uint64_t primary_key() const { return id; }
+   uint64_t by_owner() const { return owner.value; }
+
+   EOSLIB_SERIALIZE( balance, (id)(amount)(owner) )
+};
+
+using balances = multi_index<"balances"_n, balance,
+   indexed_by<"byowner"_n, const_mem_fun<balance, uint64_t, &balance::by_owner>>>;
+
+using owners = multi_index<"owners"_n, balance,
+   indexed_by<"byowner"_n, const_mem_fun<balance, uint64_t, &balance::by_owner>>>;
+
+struct config {
+   uint64_t limit = 0;
+
+   EOSLIB_SERIALIZE( config, (limit) )
+};
+
+using config_singleton = singleton<"config"_n, config>;
+
+// The part of the ABI emitted by abigen, which is used by chaindb
+static constexpr char contract_abi[] = R"({
+   "version": "cyberway::abi/1.1",
+   "structs": [
+      {"name": "balance", "base": "", "fields": [
+         {"name": "id", "type": "uint64"},
+         {"name": "amount", "type": "uint64"},
+         {"name": "owner", "type": "name"}
+      ]}
+   ],
+   "tables": [
+      {"name": "balances", "type": "balance", "indexes": [
+         {"name": "primary", "unique": true, "orders": [{"field": "id", "order": "asc"}]},
+         {"name": "byowner", "unique": false, "orders": [{"field": "owner", "order": "asc"}]}
+      ]},
+      {"name": "owners", "type": "balance", "indexes": [
+         {"name": "primary", "unique": true, "orders": [{"field": "id", "order": "asc"}]},
+         {"name": "byowner", "unique": true, "orders": [{"field": "owner", "order": "asc"}]}
+      ]}
+   ]
+})";
+
+static constexpr int64_t balance_size = 3 * sizeof(uint64_t);
+
+static void setup_chaindb() {
+   use_chaindb();
+   load_chaindb_abi(name(code_account), contract_abi);
+
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() {
+      return static_cast<uint64_t>(code_account);
+   });
+}
+
+template <typename Table>
+static void fill(uint64_t scope) {
+   Table table(code_account, scope);
+   table.emplace(alice, [](auto& b) { b.id = 1; b.owner = name(bob); });
+   table.emplace(alice, [](auto& b) { b.id = 2; b.owner = name(alice); });
+   table.emplace(bob,   [](auto& b) { b.id = 3; b.owner = name(carol); });
+}
+
+EOSIO_TEST_BEGIN(primary_index_test)
+   setup_chaindb();
+   fill<balances>(1);
+
+   balances table(code_account, 1);
+   std::vector<uint64_t> ids;
+   for (auto& b: table) {
+      ids.push_back(b.id);
+   }
+   CHECK_EQUAL( ids == std::vector<uint64_t>({1, 2, 3}), true )
+
+   CHECK_EQUAL( table.find(2)->owner, name(alice) )
+   CHECK_EQUAL( table.find(4) == table.end(), true )
+   CHECK_EQUAL( table.lower_bound(2)->id, 2 )
+   CHECK_EQUAL( table.upper_bound(2)->id, 3 )
+   CHECK_EQUAL( table.available_primary_key(), 4 )
+   CHECK_EQUAL( (--table.end())->id, 3 )
+
+   table.erase(table.get(2));
+   CHECK_EQUAL( table.find(2) == table.end(), true )
+   CHECK_EQUAL( (++table.begin())->id, 3 )
+
+   uint64_t sum = 0;
+   for (auto& b: table.range(0)) {
+      sum += b.id;
+   }
+   CHECK_EQUAL( sum, 4 )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(secondary_index_test)
+   setup_chaindb();
+   fill<balances>(2);
+
+   balances table(code_account, 2);
+   auto idx = table.get_index<"byowner"_n>();
+
+   // ordered by the field from the ABI
+   std::vector<uint64_t> ids;
+   for (auto& b: idx) {
+      ids.push_back(b.id);
+   }
+   CHECK_EQUAL( ids == std::vector<uint64_t>({2, 1, 3}), true )
+
+   CHECK_EQUAL( idx.find(name(bob).value)->id, 1 )
+   CHECK_EQUAL( idx.find(name("dave"_n).value) == idx.end(), true )
+   CHECK_EQUAL( idx.upper_bound(name(bob).value)->id, 3 )
+
+   // the index follows the updates of the object
+   table.modify(table.get(1), same_payer, [](auto& b) { b.owner = name("dave"_n); });
+   CHECK_EQUAL( idx.find(name(bob).value) == idx.end(), true )
+   CHECK_EQUAL( (--idx.end())->id, 1 )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(unique_index_test)
+   setup_chaindb();
+   fill<owners>(3);
+
+   CHECK_ASSERT( "unique key of the index already exists", ([]() {
+      owners table(code_account, 3);
+      table.emplace(alice, [](auto& b) { b.id = 4; b.owner = name(bob); });
+   }) )
+   CHECK_ASSERT( "object with the same primary key already exists", ([]() {
+      chaindb().insert(static_cast<uint64_t>(code_account), 3, "owners"_n.value, static_cast<uint64_t>(alice), 1, "", 0);
+   }) )
+
+   // the pending update releases the unique key before the insert takes it
+   fill<owners>(7);
+   owners table(code_account, 7);
+   table.set_write_back(true);
+   table.modify(table.get(1), same_payer, [](auto& b) { b.owner = "dave"_n; });
+   table.emplace(alice, [](auto& b) { b.id = 4; b.owner = name(bob); });
+   table.set_write_back(false);
+
+   auto idx = table.get_index<"byowner"_n>();
+   CHECK_EQUAL( idx.find(name(bob).value)->id, 4 )
+   CHECK_EQUAL( idx.find("dave"_n.value)->id, 1 )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(ram_test)
+   setup_chaindb();
+   fill<balances>(4);
+
+   CHECK_EQUAL( chaindb().ram_usage(name(alice).value), 2 * balance_size )
+   CHECK_EQUAL( chaindb().ram_usage(name(bob).value), balance_size )
+
+   balances table(code_account, 4);
+
+   // the new payer is charged for the object
+   table.modify(table.get(1), bob, [](auto& b) { b.amount = 10; });
+   CHECK_EQUAL( table.find(1).payer(), name(bob) )
+   CHECK_EQUAL( chaindb().ram_usage(name(alice).value), balance_size )
+   CHECK_EQUAL( chaindb().ram_usage(name(bob).value), 2 * balance_size )
+
+   // objects in the archive are not charged
+   table.move_to_archive(table.get(3));
+   CHECK_EQUAL( table.find(3).in_ram(), false )
+   CHECK_EQUAL( chaindb().ram_usage(name(bob).value), balance_size )
+
+   table.move_to_ram(table.get(3));
+   CHECK_EQUAL( chaindb().ram_usage(name(bob).value), 2 * balance_size )
+
+   table.erase(table.get(1));
+   table.erase(table.get(2));
+   table.erase(table.get(3));
+   CHECK_EQUAL( chaindb().ram_usage(name(alice).value), 0 )
+   CHECK_EQUAL( chaindb().ram_usage(name(bob).value), 0 )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(singleton_test)
+   setup_chaindb();
+
+   config_singleton cfg(name(code_account), 5);
+   CHECK_EQUAL( cfg.exists(), false )
+   CHECK_EQUAL( cfg.get_or_default().limit, 0 )
+
+   cfg.set(config{42}, name(alice));
+   CHECK_EQUAL( cfg.exists(), true )
+   CHECK_EQUAL( cfg.get().limit, 42 )
+
+   cfg.remove();
+   CHECK_EQUAL( cfg.exists(), false )
+EOSIO_TEST_END
+
+// use_chaindb() drops the objects cached by multi_index and its write-back mode together with the rows
+EOSIO_TEST_BEGIN(cache_reset_test)
+   setup_chaindb();
+   fill<balances>(6);
+   {
+      balances table(code_account, 6);
+      table.set_write_back(true);
+      CHECK_EQUAL( table.get(1).owner, name(bob) )
+   }
+
+   setup_chaindb();
+   balances table(code_account, 6);
+   CHECK_EQUAL( table.is_write_back(), false )
+   CHECK_EQUAL( table.find(1) == table.end(), true )
+   CHECK_EQUAL( table.begin() == table.end(), true )
+
+   table.emplace(alice, [](auto& b) { b.id = 1; b.owner = name(carol); });
+   CHECK_EQUAL( table.get(1).owner, name(carol) )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(primary_index_test);
+   EOSIO_TEST(secondary_index_test);
+   EOSIO_TEST(unique_index_test);
+   EOSIO_TEST(ram_test);
+   EOSIO_TEST(singleton_test);
+   EOSIO_TEST(cache_reset_test);
+   return has_failed();
+}
@@ -0,0 +1,82 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/bench.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+struct transfer {
+   name                  from;
+   name                  to;
+   asset                 quantity;
+   std::string           memo;
+   std::vector<uint64_t> ids;
+
+   EOSLIB_SERIALIZE( transfer, (from)(to)(quantity)(memo)(ids) )
+};
+
+static transfer make_transfer() {
+   return transfer{"alice"_n, "bob"_n, asset(10000, symbol("CYBER", 4)), "payment for the order #1",
+      std::vector<uint64_t>(16, 42)};
+}
+
+EOSIO_BENCH_BEGIN(pack_size_bench)
+   const auto t = make_transfer();
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(pack_size(t));
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(pack_bench)
+   const auto t = make_transfer();
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(pack(t));
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(pack_to_buffer_bench)
+   const auto t = make_transfer();
+   char buffer[512];
+   EOSIO_BENCH_LOOP {
+      datastream<char*> ds(buffer, sizeof(buffer));
+      ds << t;
+      do_not_optimize(buffer);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(unpack_bench)
+   const auto data = pack(make_transfer());
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(unpack<transfer>(data));
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(varint_bench)
+   char buffer[16 * 10];
+   EOSIO_BENCH_LOOP {
+      datastream<char*> ds(buffer, sizeof(buffer));
+      for (uint32_t v = 1; v < (1u << 31); v <<= 2) {
+         ds << unsigned_int(v);
+      }
+      do_not_optimize(buffer);
+   }
+EOSIO_BENCH_END
+
+int main(int argc, char* argv[]) {
+   if (!parse_bench_args(argc, argv))
+      return -1;
+
+   EOSIO_BENCH(pack_size_bench);
+   EOSIO_BENCH(pack_bench);
+   EOSIO_BENCH(pack_to_buffer_bench);
+   EOSIO_BENCH(unpack_bench);
+   EOSIO_BENCH(varint_bench);
+   return has_failed();
+}
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include <eosio/tester.hpp>
+#include <eosio/asset.hpp>
 #include <eosio/binary_extension.hpp>
 #include <eosio/crypto.hpp>
 #include <eosio/datastream.hpp>
@@ -556,6 +557,64 @@ EOSIO_TEST_BEGIN(datastream_stream_test)
    CHECK_EQUAL( csc, sc )
 EOSIO_TEST_END
 
+// Definitions in `eosio.cdt/libraries/eosio/datastream.hpp`
+EOSIO_TEST_BEGIN(datastream_raw_serializable_test)
+   using eosio::asset;
+   using eosio::is_raw_serializable;
+   using eosio::name;
+   using eosio::unsigned_int;
+
+   CHECK_EQUAL( is_raw_serializable<char>::value, true )
+   CHECK_EQUAL( is_raw_serializable<uint64_t>::value, true )
+   CHECK_EQUAL( is_raw_serializable<double>::value, true )
+   CHECK_EQUAL( is_raw_serializable<name>::value, true )
+   CHECK_EQUAL( is_raw_serializable<symbol_code>::value, true )
+   CHECK_EQUAL( is_raw_serializable<symbol>::value, true )
+   CHECK_EQUAL( is_raw_serializable<asset>::value, true )
+   CHECK_EQUAL( is_raw_serializable<bool>::value, false )
+   CHECK_EQUAL( is_raw_serializable<string>::value, false )
+   CHECK_EQUAL( is_raw_serializable<fixed_bytes<32>>::value, false )
+
+   // the single write produces the same bytes as the element by element serialization
+   const vector<name> names{"alice"_n, "bob"_n, "carol"_n};
+   const vector<asset> amounts{asset{10, symbol{"CYBER", 4}}, asset{-5, symbol{"GOLOS", 3}}};
+   const array<uint32_t, 3> numbers{1, 2, 0xFFFFFFFF};
+
+   char buffer[256];
+   datastream<char*> ds{buffer, sizeof(buffer)};
+   ds << names << amounts << numbers;
+   CHECK_EQUAL( ds.tellp(), 1 + 3*8 + 1 + 2*16 + 3*4 )
+   CHECK_EQUAL( pack_size(names), 1 + 3*8 )
+   CHECK_EQUAL( pack_size(amounts), 1 + 2*16 )
+   CHECK_EQUAL( pack_size(numbers), 3*4 )
+
+   char expected[256];
+   datastream<char*> eds{expected, sizeof(expected)};
+   eds << unsigned_int(names.size());
+   for (const auto& n: names) eds << n.value;
+   eds << unsigned_int(amounts.size());
+   for (const auto& a: amounts) eds << a.amount << a.symbol.raw();
+   for (const auto& n: numbers) eds.write((const char*)&n, sizeof(n));
+   CHECK_EQUAL( eds.tellp(), ds.tellp() )
+   CHECK_EQUAL( memcmp(buffer, expected, ds.tellp()), 0 )
+
+   vector<name> names2;
+   vector<asset> amounts2;
+   array<uint32_t, 3> numbers2{};
+   ds.seekp(0);
+   ds >> names2 >> amounts2 >> numbers2;
+   CHECK_EQUAL( names2 == names, true )
+   CHECK_EQUAL( amounts2 == amounts, true )
+   CHECK_EQUAL( numbers2 == numbers, true )
+
+   // a size which doesn't fit into the stream is rejected before the allocation
+   ds.seekp(0);
+   ds << unsigned_int(1000) << uint64_t(1);
+   ds.seekp(0);
+   datastream<const char*> rds{buffer, 9};
+   CHECK_ASSERT( "read", ([&]() {rds >> names2;}) )
+EOSIO_TEST_END
+
 // Definitions in `eosio.cdt/libraries/eosio/datastream.hpp`
 EOSIO_TEST_BEGIN(misc_datastream_test)
    // ---------------------------
@@ -602,6 +661,7 @@ int main(int argc, char* argv[]) {
    EOSIO_TEST(datastream_test);
    EOSIO_TEST(datastream_specialization_test);
    EOSIO_TEST(datastream_stream_test);
+   EOSIO_TEST(datastream_raw_serializable_test);
    EOSIO_TEST(misc_datastream_test);
    return has_failed();
 }
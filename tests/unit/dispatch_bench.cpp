@@ -0,0 +1,131 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <boost/preprocessor/repetition/repeat.hpp>
+
+#include <eosio/eosio.hpp>
+#include <eosio/bench.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+// Dispatch of contracts with 5, 50 and 200 actions by the switch of EOSIO_DISPATCH, by the chain of compares
+// of the apply generated by the linker and by the sorted table of the apply generated with -fdispatch-table.
+
+// "act" followed by three letters of the index
+constexpr uint64_t action_name(uint32_t i) {
+   const char str[] = {'a', 'c', 't', char('a' + i / 676 % 26), char('a' + i / 26 % 26), char('a' + i % 26)};
+   uint64_t value = 0;
+   for (uint32_t k = 0; k < sizeof(str); ++k)
+      value |= uint64_t(str[k] - 'a' + 6) << (64 - 5 * (k + 1));
+   return value;
+}
+
+static uint64_t handled = 0;
+
+template <uint32_t I>
+__attribute__((noinline)) void handler(unsigned long long r, unsigned long long c) {
+   handled += I + 1;
+   do_not_optimize(handled);
+}
+
+#define SWITCH_CASE(z, I, _) \
+   case action_name(I): handler<I>(r, c); break;
+
+#define CHAIN_IF(z, I, _) \
+   if (a == action_name(I)) return handler<I>(r, c);
+
+#define DEFINE_DISPATCHERS(N) \
+   __attribute__((noinline)) void switch_dispatch_##N(uint64_t r, uint64_t c, uint64_t a) { \
+      switch (a) { BOOST_PP_REPEAT(N, SWITCH_CASE, _) } \
+   } \
+   __attribute__((noinline)) void chain_dispatch_##N(uint64_t r, uint64_t c, uint64_t a) { \
+      BOOST_PP_REPEAT(N, CHAIN_IF, _) \
+   }
+
+DEFINE_DISPATCHERS(5)
+DEFINE_DISPATCHERS(50)
+DEFINE_DISPATCHERS(200)
+
+template <uint32_t... I>
+std::vector<dispatch_entry> make_table(std::integer_sequence<uint32_t, I...>) {
+   std::vector<dispatch_entry> table = {{0, action_name(I), &handler<I>}...};
+   std::sort(table.begin(), table.end(), [](const auto& a, const auto& b) { return a.action < b.action; });
+   return table;
+}
+
+template <uint32_t N>
+const std::vector<dispatch_entry>& table() {
+   static const auto t = make_table(std::make_integer_sequence<uint32_t, N>());
+   return t;
+}
+
+template <uint32_t N>
+__attribute__((noinline)) void table_dispatch(uint64_t r, uint64_t c, uint64_t a) {
+   const auto& t = table<N>();
+   if (const auto* e = find_dispatch_entry(t.data(), t.size(), 0, a))
+      e->handler(r, c);
+}
+
+// the actions of the benchmark loop, in a pseudo-random order so the branches aren't predicted by the order
+template <uint32_t N>
+std::array<uint64_t, 1024> make_actions() {
+   std::array<uint64_t, 1024> actions;
+   uint32_t seed = 12345;
+   for (auto& a : actions) {
+      seed = seed * 1103515245 + 12345;
+      a = action_name((seed >> 16) % N);
+   }
+
+   for (uint32_t i = 0; i < N; ++i) {
+      handled = 0;
+      table_dispatch<N>(1, 1, action_name(i));
+      check(handled == i + 1, "the dispatch table misses an action");
+   }
+   handled = 0;
+   table_dispatch<N>(1, 1, action_name(N));
+   check(handled == 0, "the dispatch table finds an unknown action");
+   return actions;
+}
+
+#define DISPATCH_BENCH(NAME, DISPATCH, N) \
+   EOSIO_BENCH_BEGIN(NAME) \
+      const auto actions = make_actions<N>(); \
+      uint32_t i = 0; \
+      EOSIO_BENCH_LOOP { \
+         DISPATCH(1, 1, actions[i++ & 1023]); \
+      } \
+   EOSIO_BENCH_END
+
+DISPATCH_BENCH(switch_dispatch_5_bench, switch_dispatch_5, 5)
+DISPATCH_BENCH(chain_dispatch_5_bench, chain_dispatch_5, 5)
+DISPATCH_BENCH(table_dispatch_5_bench, table_dispatch<5>, 5)
+DISPATCH_BENCH(switch_dispatch_50_bench, switch_dispatch_50, 50)
+DISPATCH_BENCH(chain_dispatch_50_bench, chain_dispatch_50, 50)
+DISPATCH_BENCH(table_dispatch_50_bench, table_dispatch<50>, 50)
+DISPATCH_BENCH(switch_dispatch_200_bench, switch_dispatch_200, 200)
+DISPATCH_BENCH(chain_dispatch_200_bench, chain_dispatch_200, 200)
+DISPATCH_BENCH(table_dispatch_200_bench, table_dispatch<200>, 200)
+
+int main(int argc, char* argv[]) {
+   if (!parse_bench_args(argc, argv))
+      return -1;
+
+   EOSIO_BENCH(switch_dispatch_5_bench);
+   EOSIO_BENCH(chain_dispatch_5_bench);
+   EOSIO_BENCH(table_dispatch_5_bench);
+   EOSIO_BENCH(switch_dispatch_50_bench);
+   EOSIO_BENCH(chain_dispatch_50_bench);
+   EOSIO_BENCH(table_dispatch_50_bench);
+   EOSIO_BENCH(switch_dispatch_200_bench);
+   EOSIO_BENCH(chain_dispatch_200_bench);
+   EOSIO_BENCH(table_dispatch_200_bench);
+   return has_failed();
+}
@@ -0,0 +1,170 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <eosio/tester.hpp>
+
+// The functions of eosio_cmem are built under other names, so they don't replace the ones of the native libc
+#define memset  cmem_memset
+#define memcpy  cmem_memcpy
+#define memmove cmem_memmove
+#define memcmp  cmem_memcmp
+#include "../../libraries/eosiolib/memory.cpp"
+#undef memset
+#undef memcpy
+#undef memmove
+#undef memcmp
+
+using namespace eosio::native;
+
+using std::vector;
+
+static constexpr size_t buffer_size = 96;
+
+static vector<uint8_t> pattern(uint8_t seed) {
+   vector<uint8_t> buf(buffer_size);
+   for (size_t i = 0; i < buf.size(); ++i) {
+      buf[i] = uint8_t(seed + i * 7);
+   }
+   return buf;
+}
+
+// Definitions in `eosio.cdt/libraries/eosiolib/memory.cpp`
+EOSIO_TEST_BEGIN(memset_test)
+   uint32_t failed = 0;
+   for (size_t offset = 0; offset < 16; ++offset) {
+      for (size_t n = 0; n < 40; ++n) {
+         auto buf = pattern(1);
+         auto expected = buf;
+         for (size_t i = 0; i < n; ++i) {
+            expected[offset + i] = 0xAB;
+         }
+         failed += cmem_memset(buf.data() + offset, 0xAB, n) != buf.data() + offset;
+         failed += buf != expected;
+      }
+   }
+   CHECK_EQUAL( failed, 0 )
+
+   // only the low byte of the value is used
+   auto buf = pattern(1);
+   cmem_memset(buf.data(), 0x1FF, 20);
+   CHECK_EQUAL( buf[0], 0xFF )
+   CHECK_EQUAL( buf[19], 0xFF )
+   CHECK_EQUAL( buf[20], pattern(1)[20] )
+EOSIO_TEST_END
+
+// Unaligned heads and tails of the destination and the source, with all lengths around the word size
+EOSIO_TEST_BEGIN(memcpy_test)
+   const auto src = pattern(3);
+   uint32_t failed = 0;
+   for (size_t dst_offset = 0; dst_offset < 16; ++dst_offset) {
+      for (size_t src_offset = 0; src_offset < 16; ++src_offset) {
+         for (size_t n = 0; n < 40; ++n) {
+            auto buf = pattern(100);
+            auto expected = buf;
+            for (size_t i = 0; i < n; ++i) {
+               expected[dst_offset + i] = src[src_offset + i];
+            }
+            failed += cmem_memcpy(buf.data() + dst_offset, src.data() + src_offset, n) != buf.data() + dst_offset;
+            failed += buf != expected;
+         }
+      }
+   }
+   CHECK_EQUAL( failed, 0 )
+EOSIO_TEST_END
+
+// Overlapping ranges in both directions: the result is the same as of a copy through a temporary buffer
+EOSIO_TEST_BEGIN(memmove_test)
+   uint32_t failed = 0;
+   for (size_t dst_offset = 0; dst_offset < 24; ++dst_offset) {
+      for (size_t src_offset = 0; src_offset < 24; ++src_offset) {
+         for (size_t n = 0; n < 40; ++n) {
+            auto buf = pattern(5);
+            auto expected = buf;
+            const vector<uint8_t> tmp(buf.begin() + src_offset, buf.begin() + src_offset + n);
+            std::copy(tmp.begin(), tmp.end(), expected.begin() + dst_offset);
+            failed += cmem_memmove(buf.data() + dst_offset, buf.data() + src_offset, n) != buf.data() + dst_offset;
+            failed += buf != expected;
+         }
+      }
+   }
+   CHECK_EQUAL( failed, 0 )
+
+   // the destination starts inside of the source
+   auto buf = pattern(5);
+   cmem_memmove(buf.data() + 1, buf.data(), 30);
+   CHECK_EQUAL( buf[0], pattern(5)[0] )
+   CHECK_EQUAL( buf[1], pattern(5)[0] )
+   CHECK_EQUAL( buf[30], pattern(5)[29] )
+   CHECK_EQUAL( buf[31], pattern(5)[31] )
+
+   // the source starts inside of the destination
+   buf = pattern(5);
+   cmem_memmove(buf.data(), buf.data() + 1, 30);
+   CHECK_EQUAL( buf[0], pattern(5)[1] )
+   CHECK_EQUAL( buf[29], pattern(5)[30] )
+   CHECK_EQUAL( buf[30], pattern(5)[30] )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(zero_length_test)
+   auto buf = pattern(7);
+   const auto expected = buf;
+   CHECK_EQUAL( cmem_memset(buf.data() + 3, 0, 0) == buf.data() + 3, true )
+   CHECK_EQUAL( cmem_memcpy(buf.data() + 3, buf.data() + 50, 0) == buf.data() + 3, true )
+   CHECK_EQUAL( cmem_memmove(buf.data() + 3, buf.data() + 1, 0) == buf.data() + 3, true )
+   CHECK_EQUAL( buf == expected, true )
+   CHECK_EQUAL( cmem_memcmp(buf.data(), buf.data() + 1, 0), 0 )
+   // the pointers aren't dereferenced
+   CHECK_EQUAL( cmem_memcmp(nullptr, nullptr, 0), 0 )
+EOSIO_TEST_END
+
+// The sign is given by the first different byte, compared as unsigned, not by the word containing it
+EOSIO_TEST_BEGIN(memcmp_test)
+   uint32_t failed = 0;
+   for (size_t offset = 0; offset < 8; ++offset) {
+      for (size_t n = 1; n < 40; ++n) {
+         for (size_t pos = 0; pos < n; ++pos) {
+            auto a = pattern(9);
+            auto b = a;
+            a[offset + pos] = 0x01;
+            b[offset + pos] = 0x80;
+            // the following bytes differ the other way
+            if (pos + 1 < n) {
+               a[offset + pos + 1] = 0xFF;
+               b[offset + pos + 1] = 0x00;
+            }
+            failed += cmem_memcmp(a.data() + offset, b.data() + offset, n) != -1;
+            failed += cmem_memcmp(b.data() + offset, a.data() + offset, n) != 1;
+            failed += cmem_memcmp(a.data() + offset, a.data() + offset, n) != 0;
+            // the difference is outside of the compared bytes
+            failed += cmem_memcmp(a.data() + offset, b.data() + offset, pos) != 0;
+         }
+      }
+   }
+   CHECK_EQUAL( failed, 0 )
+
+   const uint8_t a[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00};
+   const uint8_t b[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF};
+   CHECK_EQUAL( cmem_memcmp(a, b, sizeof(a)), 1 )
+   CHECK_EQUAL( cmem_memcmp(b, a, sizeof(a)), -1 )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(memset_test);
+   EOSIO_TEST(memcpy_test);
+   EOSIO_TEST(memmove_test);
+   EOSIO_TEST(zero_length_test);
+   EOSIO_TEST(memcmp_test);
+   return has_failed();
+}
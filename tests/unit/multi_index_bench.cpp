@@ -0,0 +1,168 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/bench.hpp>
+#include <eosio/chaindb.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+static constexpr auto code_account = name::raw("contract"_n);
+static constexpr auto alice    = name::raw("alice"_n);
+
+struct balance {
+   uint64_t id     = 0;
+   uint64_t amount = 0;
+   name     owner;
+
+   uint64_t primary_key() const { return id; }
+   uint64_t by_owner() const { return owner.value; }
+
+   EOSLIB_SERIALIZE( balance, (id)(amount)(owner) )
+};
+
+using balances = multi_index<"balances"_n, balance,
+   indexed_by<"byowner"_n, const_mem_fun<balance, uint64_t, &balance::by_owner>>>;
+
+static constexpr char contract_abi[] = R"({
+   "structs": [
+      {"name": "balance", "base": "", "fields": [
+         {"name": "id", "type": "uint64"},
+         {"name": "amount", "type": "uint64"},
+         {"name": "owner", "type": "name"}
+      ]}
+   ],
+   "tables": [
+      {"name": "balances", "type": "balance", "indexes": [
+         {"name": "primary", "unique": true, "orders": [{"field": "id", "order": "asc"}]},
+         {"name": "byowner", "unique": false, "orders": [{"field": "owner", "order": "asc"}]}
+      ]}
+   ]
+})";
+
+static constexpr uint64_t rows = 100;
+
+// Scopes are not shared between the benchmarks, because the object cache lives for the whole process
+static void fill(uint64_t scope) {
+   balances table(code_account, scope);
+   for (uint64_t i = 0; i < rows; ++i) {
+      table.emplace(alice, [&](auto& b) { b.id = i; b.owner = name(i + 1); });
+   }
+}
+
+// Holders are usually named accounts, so scopes are names with zero low bits
+static uint64_t holder_scope(uint64_t i) {
+   return name("holder").value + (i << 4);
+}
+
+// One row in each of the first `scopes` holder scopes
+static void fill_scopes(uint64_t scopes) {
+   static uint64_t filled = 0;
+   for (; filled < scopes; ++filled) {
+      balances table(code_account, holder_scope(filled));
+      table.emplace(alice, [&](auto& b) { b.id = filled; b.owner = name(alice); });
+   }
+}
+
+EOSIO_BENCH_BEGIN(find_bench)
+   fill(1);
+   balances table(code_account, 1);
+   uint64_t pk = 0;
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(table.find(pk++ % rows)->amount);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(modify_bench)
+   fill(2);
+   balances table(code_account, 2);
+   uint64_t pk = 0;
+   EOSIO_BENCH_LOOP {
+      table.modify(table.get(pk++ % rows), same_payer, [](auto& b) { ++b.amount; });
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(emplace_erase_bench)
+   balances table(code_account, 3);
+   EOSIO_BENCH_LOOP {
+      auto itr = table.emplace(alice, [](auto& b) { b.id = 1; b.owner = name(alice); });
+      table.erase(itr);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(iterate_bench)
+   fill(4);
+   balances table(code_account, 4);
+   EOSIO_BENCH_LOOP {
+      uint64_t sum = 0;
+      for (auto& b: table) {
+         sum += b.id;
+      }
+      do_not_optimize(sum);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(range_bench)
+   fill(5);
+   balances table(code_account, 5);
+   EOSIO_BENCH_LOOP {
+      uint64_t sum = 0;
+      for (auto& b: table.range(0)) {
+         sum += b.id;
+      }
+      do_not_optimize(sum);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(secondary_find_bench)
+   fill(6);
+   balances table(code_account, 6);
+   auto idx = table.get_index<"byowner"_n>();
+   uint64_t owner = 0;
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(idx.find(owner++ % rows + 1)->id);
+   }
+EOSIO_BENCH_END
+
+// multi_index(code, scope) and find() of a cached row cost the same for any number of opened scopes
+EOSIO_BENCH_BEGIN(scopes_10_bench)
+   fill_scopes(10);
+   uint64_t i = 0;
+   EOSIO_BENCH_LOOP {
+      balances table(code_account, holder_scope(i % 10));
+      do_not_optimize(table.find(i++ % 10)->amount);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(scopes_10000_bench)
+   fill_scopes(10000);
+   uint64_t i = 0;
+   EOSIO_BENCH_LOOP {
+      balances table(code_account, holder_scope(i % 10000));
+      do_not_optimize(table.find(i++ % 10000)->amount);
+   }
+EOSIO_BENCH_END
+
+int main(int argc, char* argv[]) {
+   if (!parse_bench_args(argc, argv))
+      return -1;
+
+   use_chaindb();
+   load_chaindb_abi(name(code_account), contract_abi);
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() {
+      return static_cast<uint64_t>(code_account);
+   });
+
+   EOSIO_BENCH(find_bench);
+   EOSIO_BENCH(modify_bench);
+   EOSIO_BENCH(emplace_erase_bench);
+   EOSIO_BENCH(iterate_bench);
+   EOSIO_BENCH(range_bench);
+   EOSIO_BENCH(secondary_find_bench);
+   EOSIO_BENCH(scopes_10_bench);
+   EOSIO_BENCH(scopes_10000_bench);
+   return has_failed();
+}
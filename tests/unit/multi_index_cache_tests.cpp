@@ -0,0 +1,140 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+#include <eosio/chaindb.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+using eosio::_detail::flat_hash_map;
+using eosio::_detail::uint64_hash;
+
+static constexpr auto code_account = name::raw("contract"_n);
+static constexpr auto alice        = name::raw("alice"_n);
+
+struct row {
+   uint64_t id    = 0;
+   uint64_t value = 0;
+
+   uint64_t primary_key() const { return id; }
+
+   EOSLIB_SERIALIZE( row, (id)(value) )
+};
+
+using rows_table = multi_index<"rows"_n, row>;
+
+static constexpr char contract_abi[] = R"({
+   "version": "cyberway::abi/1.1",
+   "structs": [
+      {"name": "row", "base": "", "fields": [
+         {"name": "id", "type": "uint64"},
+         {"name": "value", "type": "uint64"}
+      ]}
+   ],
+   "tables": [
+      {"name": "rows", "type": "row", "indexes": [
+         {"name": "primary", "unique": true, "orders": [{"field": "id", "order": "asc"}]}
+      ]}
+   ]
+})";
+
+// Holders are usually named accounts, so scopes are names with zero low bits
+static uint64_t holder_scope(uint64_t i) {
+   return name("holder").value + (i << 4);
+}
+
+EOSIO_TEST_BEGIN(flat_hash_map_test)
+   flat_hash_map<uint64_t, int, uint64_hash> map;
+   CHECK_EQUAL( map.empty(), true )
+   CHECK_EQUAL( map.find(1) == nullptr, true )
+   CHECK_EQUAL( map.erase(1), false )
+   // an empty map doesn't look at its slots
+   CHECK_EQUAL( map.stats().lookups, 2 )
+   CHECK_EQUAL( map.stats().probes, 0 )
+
+   for (int i = 0; i < 1000; ++i) {
+      map.insert(i * 16, i);
+   }
+   CHECK_EQUAL( map.size(), 1000 )
+   for (int i = 0; i < 1000; ++i) {
+      auto ptr = map.find(i * 16);
+      REQUIRE_EQUAL( ptr != nullptr, true )
+      CHECK_EQUAL( *ptr, i )
+   }
+
+   // overwrite keeps size
+   map.insert(16, -1);
+   CHECK_EQUAL( map.size(), 1000 )
+   CHECK_EQUAL( *map.find(16), -1 )
+
+   // erase every other key, the rest must still be reachable after backward shifts
+   for (int i = 0; i < 1000; i += 2) {
+      CHECK_EQUAL( map.erase(i * 16), true )
+   }
+   CHECK_EQUAL( map.size(), 500 )
+   for (int i = 0; i < 1000; ++i) {
+      CHECK_EQUAL( map.find(i * 16) != nullptr, (i % 2) == 1 )
+   }
+
+   int visited = 0;
+   map.for_each([&](const auto&, auto&) { ++visited; });
+   CHECK_EQUAL( visited, 500 )
+
+   map.clear();
+   CHECK_EQUAL( map.empty(), true )
+   CHECK_EQUAL( map.find(17 * 16) == nullptr, true )
+EOSIO_TEST_END
+
+// multi_index(code, scope) finds the cache of the scope by one lookup with a short probe sequence for any number
+// of opened scopes, a linear scan would compare about half of the scopes; multi_index_bench reports the times
+EOSIO_TEST_BEGIN(scope_cache_test)
+   use_chaindb();
+   load_chaindb_abi(name(code_account), contract_abi);
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() {
+      return static_cast<uint64_t>(code_account);
+   });
+
+   const auto& stats = rows_table::scope_cache_stats();
+   uint64_t opened = 0;
+   for (uint64_t scopes: {10, 100, 1000, 10000}) {
+      // one row in each new scope, it stays in the object cache
+      for (; opened < scopes; ++opened) {
+         rows_table table(code_account, holder_scope(opened));
+         table.emplace(alice, [&](auto& r) { r.id = opened; r.value = opened + 1; });
+      }
+
+      const auto lookups = stats.lookups;
+      const auto probes = stats.probes;
+      const auto datasize_calls = intrinsics::get().call_counts[intrinsics::chaindb_datasize];
+
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < scopes; ++i) {
+         rows_table table(code_account, holder_scope(i));
+         sum += table.find(i)->value;
+      }
+      CHECK_EQUAL( sum, scopes * (scopes + 1) / 2 )
+
+      CHECK_EQUAL( stats.lookups - lookups, scopes )
+      CHECK_EQUAL( stats.probes - probes < 3 * scopes, true )
+
+      // all rows are found in the object cache
+      CHECK_EQUAL( intrinsics::get().call_counts[intrinsics::chaindb_datasize], datasize_calls )
+   }
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(flat_hash_map_test);
+   EOSIO_TEST(scope_cache_test);
+   return has_failed();
+}
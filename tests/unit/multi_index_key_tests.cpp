@@ -0,0 +1,93 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+using eosio::_detail::fixed_pack_size;
+
+static std::vector<char> ___last_key;
+static int32_t ___lower_bound_calls = 0;
+
+static void setup_chaindb() {
+   intrinsics::set_intrinsic<intrinsics::chaindb_lower_bound>([](auto, auto, auto, auto, void* key, int32_t size) {
+      ___last_key.assign((char*)key, (char*)key + size);
+      return ++___lower_bound_calls;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_upper_bound>([](auto, auto, auto, auto, void* key, int32_t size) {
+      ___last_key.assign((char*)key, (char*)key + size);
+      return ++___lower_bound_calls;
+   });
+}
+
+// A fixed-size key must be packed exactly as the generic path packs it
+template<typename Key>
+static bool packs_as_generic(const Key& key) {
+   ___last_key.clear();
+   lower_bound<"table"_n, "index"_n>()(name::raw("code"_n), 0, key);
+   auto lower = ___last_key;
+
+   ___last_key.clear();
+   upper_bound<"table"_n, "index"_n>()(name::raw("code"_n), 0, key);
+   return lower == pack(key) && ___last_key == lower;
+}
+
+EOSIO_TEST_BEGIN(fixed_pack_size_test)
+   CHECK_EQUAL( fixed_pack_size<uint64_t>::value, 8 )
+   CHECK_EQUAL( fixed_pack_size<int32_t>::value, 4 )
+   CHECK_EQUAL( fixed_pack_size<bool>::value, 1 )
+   CHECK_EQUAL( fixed_pack_size<double>::value, 8 )
+   CHECK_EQUAL( fixed_pack_size<name>::value, 8 )
+   CHECK_EQUAL( fixed_pack_size<symbol_code>::value, 8 )
+   CHECK_EQUAL( fixed_pack_size<symbol>::value, 8 )
+   CHECK_EQUAL( fixed_pack_size<time_point_sec>::value, 4 )
+   CHECK_EQUAL( fixed_pack_size<time_point>::value, 8 )
+   CHECK_EQUAL( fixed_pack_size<checksum256>::value, 32 )
+   CHECK_EQUAL( fixed_pack_size<checksum160>::value, 20 )
+   CHECK_EQUAL( (fixed_pack_size<std::array<uint32_t, 3>>::value), 12 )
+   CHECK_EQUAL( (fixed_pack_size<std::tuple<name, uint64_t>>::value), 16 )
+   CHECK_EQUAL( (fixed_pack_size<std::tuple<name, std::tuple<symbol_code, checksum256>>>::value), 48 )
+   CHECK_EQUAL( (fixed_pack_size<std::pair<name, bool>>::value), 9 )
+
+   // variable-length keys stay on the generic path
+   CHECK_EQUAL( fixed_pack_size<std::string>::value, 0 )
+   CHECK_EQUAL( fixed_pack_size<std::vector<char>>::value, 0 )
+   CHECK_EQUAL( fixed_pack_size<std::optional<uint64_t>>::value, 0 )
+   CHECK_EQUAL( (fixed_pack_size<std::tuple<name, std::string>>::value), 0 )
+   CHECK_EQUAL( (fixed_pack_size<std::array<std::string, 2>>::value), 0 )
+   CHECK_EQUAL( fixed_pack_size<std::tuple<>>::value, 0 )
+
+   const auto key = std::make_tuple(name("alice"), symbol("CYBER", 4), time_point_sec(1000), uint8_t(7));
+   CHECK_EQUAL( fixed_pack_size<std::decay_t<decltype(key)>>::value, pack_size(key) )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(pack_key_test)
+   setup_chaindb();
+
+   CHECK_EQUAL( packs_as_generic(uint64_t(42)), true )
+   CHECK_EQUAL( packs_as_generic(name("alice")), true )
+   CHECK_EQUAL( packs_as_generic(checksum256(std::array<uint8_t, 32>{1, 2, 3, 4})), true )
+   CHECK_EQUAL( packs_as_generic(std::make_tuple(name("alice"), symbol_code("CYBER"), true)), true )
+   CHECK_EQUAL( packs_as_generic(std::make_tuple(name("alice"), std::string("variable length key"))), true )
+   CHECK_EQUAL( packs_as_generic(std::string(1000, 'x')), true )
+   CHECK_EQUAL( ___last_key.size(), 1002 )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(fixed_pack_size_test);
+   EOSIO_TEST(pack_key_test);
+   return has_failed();
+}
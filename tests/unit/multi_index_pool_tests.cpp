@@ -0,0 +1,162 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <map>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+using eosio::_detail::object_pool;
+
+static constexpr auto code_account = name::raw("contract"_n);
+
+struct row {
+   uint64_t id = 0;
+   uint64_t value = 0;
+
+   uint64_t primary_key() const { return id; }
+
+   EOSLIB_SERIALIZE( row, (id)(value) )
+};
+
+using rows = multi_index<"rows"_n, row>;
+
+// Read-only chaindb with rows ordered by primary key
+static std::map<uint64_t, std::vector<char>> ___rows;
+static std::map<cursor_t, uint64_t> ___cursors;
+static cursor_t ___next_cursor = 1;
+
+static uint64_t position(uint64_t pk) {
+   auto itr = ___rows.lower_bound(pk);
+   return itr == ___rows.end() ? end_primary_key : itr->first;
+}
+
+static cursor_t open_cursor(uint64_t pk) {
+   ___cursors[___next_cursor] = pk;
+   return ___next_cursor++;
+}
+
+static void setup_chaindb(uint64_t count) {
+   for (uint64_t i = 0; i < count; ++i) {
+      ___rows[i] = pack(row{i, i * 10});
+   }
+
+   intrinsics::set_intrinsic<intrinsics::chaindb_lower_bound_pk>([](auto, auto, auto, primary_key_t pk) {
+      return open_cursor(position(pk));
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_begin>([](auto, auto, auto, auto) {
+      return open_cursor(position(0));
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_end>([](auto, auto, auto, auto) {
+      return open_cursor(end_primary_key);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_clone>([](auto, cursor_t cursor) {
+      return open_cursor(___cursors[cursor]);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_close>([](auto, cursor_t cursor) {
+      ___cursors.erase(cursor);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_current>([](auto, cursor_t cursor) {
+      return ___cursors[cursor];
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_next>([](auto, cursor_t cursor) {
+      auto& pk = ___cursors[cursor];
+      pk = position(pk + 1);
+      return pk;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_datasize>([](auto, cursor_t cursor) {
+      return int32_t(___rows[___cursors[cursor]].size());
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_data>([](auto, cursor_t cursor, void* data, int32_t size) {
+      auto pk = ___cursors[cursor];
+      memcpy(data, ___rows[pk].data(), size);
+      return pk;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_service>([](auto, cursor_t, void* data, int32_t size) {
+      memset(data, 0, size);
+      return size;
+   });
+}
+
+EOSIO_TEST_BEGIN(object_pool_test)
+   object_pool<24, 8> pool;
+
+   std::vector<void*> slots;
+   for (int i = 0; i < 8; ++i) {
+      slots.push_back(pool.allocate());
+   }
+   // the first slab has 8 slots
+   CHECK_EQUAL( pool.stats().misses, 1 )
+   CHECK_EQUAL( pool.stats().hits, 7 )
+   CHECK_EQUAL( pool.stats().in_use, 8 )
+   for (int i = 1; i < 8; ++i) {
+      CHECK_EQUAL( (char*)slots[i] - (char*)slots[i - 1], 24 )
+   }
+
+   // the next slab is twice as large
+   pool.allocate();
+   CHECK_EQUAL( pool.stats().misses, 2 )
+
+   // released slots are reused in the LIFO order
+   pool.deallocate(slots[3]);
+   pool.deallocate(slots[5]);
+   CHECK_EQUAL( pool.stats().in_use, 7 )
+   CHECK_EQUAL( pool.allocate() == slots[5], true )
+   CHECK_EQUAL( pool.allocate() == slots[3], true )
+   CHECK_EQUAL( pool.stats().misses, 2 )
+   CHECK_EQUAL( pool.stats().in_use, 9 )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(item_pool_bench)
+   constexpr uint64_t row_count = 10000;
+   setup_chaindb(row_count);
+
+   rows table(code_account, 0);
+   const auto start = rows::item_pool_stats();
+
+   uint64_t sum = 0;
+   for (auto& obj: table) {
+      sum += obj.value;
+   }
+   CHECK_EQUAL( sum, (row_count - 1) * row_count / 2 * 10 )
+
+   const auto scan = rows::item_pool_stats();
+   const auto allocs = (scan.hits + scan.misses) - (start.hits + start.misses);
+   const auto slabs = scan.misses - start.misses;
+   eosio::print("rows: ", row_count, ", item allocations: ", allocs, ", heap allocations: ", slabs, "\n");
+
+   CHECK_EQUAL( allocs, row_count )
+   CHECK_EQUAL( slabs < row_count / 100, true )
+   CHECK_EQUAL( scan.in_use, row_count )
+
+   // released objects are reused by the next scan, the heap doesn't grow
+   table.flush_cache();
+   CHECK_EQUAL( rows::item_pool_stats().in_use, 0 )
+
+   for (auto& obj: table) {
+      sum -= obj.value;
+   }
+   CHECK_EQUAL( sum, 0 )
+
+   const auto rescan = rows::item_pool_stats();
+   eosio::print("second scan, heap allocations: ", rescan.misses - scan.misses, "\n");
+   CHECK_EQUAL( rescan.misses, scan.misses )
+   CHECK_EQUAL( rescan.hits - scan.hits, row_count )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(object_pool_test);
+   EOSIO_TEST(item_pool_bench);
+   return has_failed();
+}
@@ -0,0 +1,224 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+#include <eosio/chaindb.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+static constexpr auto code_account = name::raw("contract"_n);
+static constexpr auto alice        = name::raw("alice"_n);
+
+struct row {
+   uint64_t id    = 0;
+   uint64_t value = 0;
+
+   uint64_t primary_key() const { return id; }
+
+   EOSLIB_SERIALIZE( row, (id)(value) )
+};
+
+struct blob {
+   uint64_t          id = 0;
+   std::vector<char> data;
+
+   uint64_t primary_key() const { return id; }
+
+   EOSLIB_SERIALIZE( blob, (id)(data) )
+};
+
+using rows_table  = multi_index<"rows"_n, row>;
+using blobs_table = multi_index<"blobs"_n, blob>;
+
+static constexpr char contract_abi[] = R"({
+   "version": "cyberway::abi/1.1",
+   "structs": [
+      {"name": "row", "base": "", "fields": [
+         {"name": "id", "type": "uint64"},
+         {"name": "value", "type": "uint64"}
+      ]},
+      {"name": "blob", "base": "", "fields": [
+         {"name": "id", "type": "uint64"},
+         {"name": "data", "type": "bytes"}
+      ]}
+   ],
+   "tables": [
+      {"name": "rows", "type": "row", "indexes": [
+         {"name": "primary", "unique": true, "orders": [{"field": "id", "order": "asc"}]}
+      ]},
+      {"name": "blobs", "type": "blob", "indexes": [
+         {"name": "primary", "unique": true, "orders": [{"field": "id", "order": "asc"}]}
+      ]}
+   ]
+})";
+
+static void setup_chaindb() {
+   use_chaindb();
+   load_chaindb_abi(name(code_account), contract_abi);
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() {
+      return static_cast<uint64_t>(code_account);
+   });
+}
+
+static void fill(uint64_t scope, uint64_t rows) {
+   rows_table table(code_account, scope);
+   for (uint64_t i = 0; i < rows; ++i) {
+      table.emplace(alice, [&](auto& r) { r.id = i; r.value = i * 10; });
+   }
+   table.flush_cache();
+}
+
+template<typename Range>
+static std::vector<uint64_t> range_keys(Range&& range) {
+   std::vector<uint64_t> keys;
+   for (auto& r: range) {
+      keys.push_back(r.id);
+   }
+   return keys;
+}
+
+// Definitions in `eosio.cdt/libraries/eosio/multi_index.hpp`
+EOSIO_TEST_BEGIN(range_bounds_test)
+   setup_chaindb();
+   fill(1, 10);
+   rows_table table(code_account, 1);
+
+   CHECK_EQUAL( (range_keys(table.range(2, 5)) == std::vector<uint64_t>{2, 3, 4}), true )
+   CHECK_EQUAL( (range_keys(table.range(7)) == std::vector<uint64_t>{7, 8, 9}), true )
+   CHECK_EQUAL( range_keys(table.range(0)).size(), 10 )
+   CHECK_EQUAL( range_keys(table.range(3, 3)).empty(), true )
+   CHECK_EQUAL( range_keys(table.range(5, 4)).empty(), true )
+   CHECK_EQUAL( range_keys(table.range(100)).empty(), true )
+   CHECK_EQUAL( (range_keys(table.range(8, 100)) == std::vector<uint64_t>{8, 9}), true )
+
+   auto range = table.range(4, 6);
+   auto itr = range.begin();
+   CHECK_EQUAL( itr.pk(), 4 )
+   CHECK_EQUAL( itr->value, 40 )
+   ++itr;
+   CHECK_EQUAL( itr.pk(), 5 )
+   ++itr;
+   CHECK_EQUAL( itr == range.end(), true )
+EOSIO_TEST_END
+
+// Rows are fetched in chunks of chunk_rows, the next chunk is fetched when the current one is read
+EOSIO_TEST_BEGIN(range_chunk_test)
+   setup_chaindb();
+   fill(2, 48);
+   rows_table table(code_account, 2);
+
+   const auto fetches = intrinsics::get().call_counts[intrinsics::chaindb_fetch];
+   const auto keys = range_keys(table.range(0, end_primary_key, 4));
+   REQUIRE_EQUAL( keys.size(), 48 )
+   for (uint64_t i = 0; i < keys.size(); ++i) {
+      CHECK_EQUAL( keys[i], i )
+   }
+   // 12 chunks and the empty one at the end
+   CHECK_EQUAL( intrinsics::get().call_counts[intrinsics::chaindb_fetch] - fetches, 13 )
+
+   // a chunk of one row
+   CHECK_EQUAL( range_keys(table.range(10, 20, 1)).size(), 10 )
+
+   CHECK_ASSERT( "invalid number of rows in chunk", ([&]() {
+      table.range(0, end_primary_key, 0);
+   }) )
+EOSIO_TEST_END
+
+// A row larger than the buffer of the range is fetched again into the grown buffer
+EOSIO_TEST_BEGIN(range_large_row_test)
+   setup_chaindb();
+   blobs_table table(code_account, 3);
+   table.emplace(alice, [](auto& b) { b.id = 1; b.data.assign(10, 'a'); });
+   table.emplace(alice, [](auto& b) { b.id = 2; b.data.assign(3000, 'b'); });
+   table.emplace(alice, [](auto& b) { b.id = 3; b.data.assign(10, 'c'); });
+   table.emplace(alice, [](auto& b) { b.id = 4; b.data.assign(5000, 'd'); });
+   table.flush_cache();
+
+   std::vector<uint64_t> sizes;
+   for (auto& b: table.range(0)) {
+      sizes.push_back(b.data.size());
+      CHECK_EQUAL( b.data.front(), char('a' + b.id - 1) )
+   }
+   CHECK_EQUAL( (sizes == std::vector<uint64_t>{10, 3000, 10, 5000}), true )
+EOSIO_TEST_END
+
+// Rows erased after their chunk had been fetched are skipped and never come back into the cache
+EOSIO_TEST_BEGIN(range_erase_test)
+   setup_chaindb();
+   fill(4, 10);
+   rows_table table(code_account, 4);
+   rows_table other(code_account, 4);
+
+   std::vector<uint64_t> keys;
+   for (auto& r: table.range(0)) {
+      keys.push_back(r.id);
+      if (r.id == 2) {
+         table.erase(table.get(5));
+         other.erase(other.get(3));
+         table.modify(table.get(8), alice, [](auto& r) { r.value = 800; });
+      }
+      if (r.id == 6) {
+         // the current row
+         table.erase(table.get(6));
+      }
+   }
+   CHECK_EQUAL( (keys == std::vector<uint64_t>{0, 1, 2, 4, 6, 7, 8, 9}), true )
+
+   CHECK_EQUAL( table.find(3) == table.end(), true )
+   CHECK_EQUAL( table.find(5) == table.end(), true )
+   CHECK_EQUAL( table.find(6) == table.end(), true )
+   CHECK_EQUAL( table.get(8).value, 800 )
+   CHECK_EQUAL( (range_keys(table.range(0)) == std::vector<uint64_t>{0, 1, 2, 4, 7, 8, 9}), true )
+
+   // the erased row can be emplaced again
+   table.emplace(alice, [](auto& r) { r.id = 5; r.value = 55; });
+   CHECK_EQUAL( table.get(5).value, 55 )
+
+   // dereference of the current row after its erase
+   CHECK_ASSERT( "object was erased", ([&]() {
+      auto range = table.range(9);
+      auto itr = range.begin();
+      table.erase(table.get(9));
+      itr->value;
+   }) )
+EOSIO_TEST_END
+
+// Rows prefetched before the cache was flushed are loaded again from the table
+EOSIO_TEST_BEGIN(range_flush_cache_test)
+   setup_chaindb();
+   fill(5, 10);
+   rows_table table(code_account, 5);
+
+   std::vector<uint64_t> values;
+   for (auto& r: table.range(0)) {
+      values.push_back(r.value);
+      if (r.id == 1) {
+         table.modify(table.get(3), alice, [](auto& r) { r.value = 300; });
+         table.flush_cache();
+      }
+   }
+   REQUIRE_EQUAL( values.size(), 10 )
+   CHECK_EQUAL( values[3], 300 )
+   CHECK_EQUAL( values[4], 40 )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(range_bounds_test);
+   EOSIO_TEST(range_chunk_test);
+   EOSIO_TEST(range_large_row_test);
+   EOSIO_TEST(range_erase_test);
+   EOSIO_TEST(range_flush_cache_test);
+   return has_failed();
+}
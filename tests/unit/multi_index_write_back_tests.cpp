@@ -0,0 +1,303 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+static constexpr auto code_account = name::raw("contract"_n);
+static constexpr auto alice    = name::raw("alice"_n);
+static constexpr auto bob      = name::raw("bob"_n);
+
+struct balance {
+   uint64_t id     = 0;
+   uint64_t amount = 0;
+   name     owner;
+
+   uint64_t primary_key() const { return id; }
+   uint64_t by_owner() const { return owner.value; }
+
+   EOSLIB_SERIALIZE( balance, (id)(amount)(owner) )
+};
+
+using balances = multi_index<"balances"_n, balance,
+   indexed_by<"byowner"_n, const_mem_fun<balance, uint64_t, &balance::by_owner>>>;
+
+// Minimal chaindb: one table with rows ordered by primary key, it logs all writes
+struct mock_chaindb {
+   std::map<uint64_t, std::vector<char>> rows;
+   std::map<cursor_t, uint64_t> cursors;
+   std::vector<std::string> log;
+   cursor_t next_cursor = 1;
+
+   cursor_t open(uint64_t pk) {
+      cursors[next_cursor] = pk;
+      return next_cursor++;
+   }
+
+   uint64_t position(uint64_t pk) const {
+      auto itr = rows.lower_bound(pk);
+      return itr == rows.end() ? end_primary_key : itr->first;
+   }
+
+   void write(const char* op, uint64_t pk, payer_name_t payer) {
+      log.push_back(std::string(op) + " " + std::to_string(pk) + " " + name(payer).to_string());
+   }
+};
+
+static mock_chaindb db;
+
+static void setup_chaindb() {
+   db = mock_chaindb();
+
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() {
+      return static_cast<uint64_t>(code_account);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_lower_bound_pk>([](auto, auto, auto, primary_key_t pk) {
+      return db.open(db.position(pk));
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_lower_bound>([](auto, auto, auto, auto, void*, int32_t) {
+      db.log.push_back("lower_bound");
+      return db.open(end_primary_key);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_begin>([](auto, auto, auto, auto) {
+      return db.open(db.position(0));
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_end>([](auto, auto, auto, auto) {
+      return db.open(end_primary_key);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_clone>([](auto, cursor_t cursor) {
+      return db.open(db.cursors[cursor]);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_close>([](auto, cursor_t cursor) {
+      db.cursors.erase(cursor);
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_current>([](auto, cursor_t cursor) {
+      return db.cursors[cursor];
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_next>([](auto, cursor_t cursor) {
+      auto& pk = db.cursors[cursor];
+      pk = db.position(pk + 1);
+      return pk;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_datasize>([](auto, cursor_t cursor) {
+      return int32_t(db.rows[db.cursors[cursor]].size());
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_data>([](auto, cursor_t cursor, void* data, int32_t size) {
+      auto pk = db.cursors[cursor];
+      memcpy(data, db.rows[pk].data(), size);
+      return pk;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_service>([](auto, cursor_t, void* data, int32_t size) {
+      memset(data, 0, size);
+      return size;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_insert>([](auto, auto, auto, payer_name_t payer, primary_key_t pk, void* data, int32_t size) {
+      db.rows[pk].assign((char*)data, (char*)data + size);
+      db.write("insert", pk, payer);
+      return size;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_update>([](auto, auto, auto, payer_name_t payer, primary_key_t pk, void* data, int32_t size) {
+      db.rows[pk].assign((char*)data, (char*)data + size);
+      db.write("update", pk, payer);
+      return 0;
+   });
+   intrinsics::set_intrinsic<intrinsics::chaindb_delete>([](auto, auto, auto, payer_name_t payer, primary_key_t pk) {
+      db.rows.erase(pk);
+      db.write("delete", pk, payer);
+      return 0;
+   });
+}
+
+static balance stored(uint64_t pk) {
+   balance b;
+   auto& data = db.rows[pk];
+   datastream<const char*> ds(data.data(), data.size());
+   ds >> b;
+   return b;
+}
+
+// Scopes are not shared between the tests, because the object cache lives for the whole process
+static void fill(uint64_t scope) {
+   balances table(code_account, scope);
+   for (uint64_t i = 1; i <= 3; ++i) {
+      table.emplace(alice, [&](auto& b) { b.id = i; b.owner = name(alice); });
+   }
+   db.log.clear();
+}
+
+EOSIO_TEST_BEGIN(write_through_test)
+   setup_chaindb();
+   fill(1);
+
+   balances table(code_account, 1);
+   CHECK_EQUAL( table.is_write_back(), false )
+
+   auto& obj = table.get(1);
+   for (int i = 0; i < 3; ++i) {
+      table.modify(obj, same_payer, [](auto& b) { b.amount += 10; });
+   }
+   CHECK_EQUAL( db.log.size(), 3 )
+   CHECK_EQUAL( stored(1).amount, 30 )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(write_back_coalescing_test)
+   setup_chaindb();
+   fill(2);
+
+   {
+      balances table(code_account, 2);
+      table.set_write_back(true);
+
+      auto& obj = table.get(1);
+      for (int i = 0; i < 10; ++i) {
+         table.modify(obj, same_payer, [](auto& b) { b.amount += 10; });
+      }
+      CHECK_EQUAL( db.log.size(), 0 )
+      CHECK_EQUAL( stored(1).amount, 0 )
+      CHECK_EQUAL( table.get(1).amount, 100 )
+
+      table.flush_cache();
+      REQUIRE_EQUAL( db.log.size(), 1 )
+      CHECK_EQUAL( db.log[0], "update 1 " )
+      CHECK_EQUAL( stored(1).amount, 100 )
+
+      // the object is reloaded after flush_cache
+      table.modify(table.get(2), same_payer, [](auto& b) { b.amount = 7; });
+      CHECK_EQUAL( db.log.size(), 1 )
+   }
+
+   // the table object is destroyed: dirty objects are written
+   REQUIRE_EQUAL( db.log.size(), 2 )
+   CHECK_EQUAL( db.log[1], "update 2 " )
+   CHECK_EQUAL( stored(2).amount, 7 )
+
+   balances table(code_account, 2);
+   table.set_write_back(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(write_back_payer_test)
+   setup_chaindb();
+   fill(3);
+
+   balances table(code_account, 3);
+   table.set_write_back(true);
+
+   // the last non-empty payer is charged
+   table.modify(table.get(1), bob, [](auto& b) { b.amount = 1; });
+   table.modify(table.get(1), same_payer, [](auto& b) { b.amount = 2; });
+
+   table.modify(table.get(2), bob, [](auto& b) { b.amount = 1; });
+   table.modify(table.get(2), alice, [](auto& b) { b.amount = 2; });
+
+   table.modify(table.get(3), same_payer, [](auto& b) { b.amount = 1; });
+
+   table.flush_cache();
+   REQUIRE_EQUAL( db.log.size(), 3 )
+   CHECK_EQUAL( db.log[0], "update 1 bob" )
+   CHECK_EQUAL( db.log[1], "update 2 alice" )
+   CHECK_EQUAL( db.log[2], "update 3 " )
+
+   CHECK_EQUAL( table.get(1).amount, 2 )
+
+   table.set_write_back(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(write_back_erase_order_test)
+   setup_chaindb();
+   fill(4);
+
+   balances table(code_account, 4);
+   table.set_write_back(true);
+
+   table.modify(table.get(1), same_payer, [](auto& b) { b.amount = 1; });
+   table.modify(table.get(2), same_payer, [](auto& b) { b.amount = 2; });
+   table.modify(table.get(1), same_payer, [](auto& b) { b.amount = 3; });
+
+   // other objects are written before the delete, the erased object isn't written
+   table.erase(table.get(1));
+   REQUIRE_EQUAL( db.log.size(), 2 )
+   CHECK_EQUAL( db.log[0], "update 2 " )
+   CHECK_EQUAL( db.log[1], "delete 1 " )
+   CHECK_EQUAL( db.rows.count(1), 0 )
+   CHECK_EQUAL( stored(2).amount, 2 )
+
+   // erase of the only modified object only deletes it
+   table.modify(table.get(3), same_payer, [](auto& b) { b.amount = 4; });
+   table.erase(table.get(3));
+   REQUIRE_EQUAL( db.log.size(), 3 )
+   CHECK_EQUAL( db.log[2], "delete 3 " )
+
+   table.flush_cache();
+   CHECK_EQUAL( db.log.size(), 3 )
+
+   table.set_write_back(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(write_back_secondary_index_test)
+   setup_chaindb();
+   fill(5);
+
+   balances table(code_account, 5);
+   table.set_write_back(true);
+
+   table.modify(table.get(1), same_payer, [](auto& b) { b.owner = name(bob); });
+   CHECK_EQUAL( db.log.size(), 0 )
+
+   // chaindb orders secondary indices, so it gets the last state first
+   auto idx = table.get_index<"byowner"_n>();
+   idx.find(name(bob).value);
+   REQUIRE_EQUAL( db.log.size(), 2 )
+   CHECK_EQUAL( db.log[0], "update 1 " )
+   CHECK_EQUAL( db.log[1], "lower_bound" )
+   CHECK_EQUAL( stored(1).owner, name(bob) )
+
+   table.set_write_back(false);
+EOSIO_TEST_END
+
+// An emplaced object can take the unique key released by a pending update, so the update is written first
+EOSIO_TEST_BEGIN(write_back_emplace_order_test)
+   setup_chaindb();
+   fill(6);
+
+   balances table(code_account, 6);
+   table.set_write_back(true);
+
+   table.modify(table.get(1), same_payer, [](auto& b) { b.owner = name(bob); });
+   CHECK_EQUAL( db.log.size(), 0 )
+
+   table.emplace(alice, [](auto& b) { b.id = 4; b.owner = name(alice); });
+   REQUIRE_EQUAL( db.log.size(), 2 )
+   CHECK_EQUAL( db.log[0], "update 1 " )
+   CHECK_EQUAL( db.log[1], "insert 4 alice" )
+   CHECK_EQUAL( stored(1).owner, name(bob) )
+
+   table.flush_cache();
+   CHECK_EQUAL( db.log.size(), 2 )
+
+   table.set_write_back(false);
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(write_through_test);
+   EOSIO_TEST(write_back_coalescing_test);
+   EOSIO_TEST(write_back_payer_test);
+   EOSIO_TEST(write_back_erase_order_test);
+   EOSIO_TEST(write_back_secondary_index_test);
+   EOSIO_TEST(write_back_emplace_order_test);
+   return has_failed();
+}
@@ -0,0 +1,51 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+
+#include <eosio/eosio.hpp>
+#include <eosio/bench.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+EOSIO_BENCH_BEGIN(name_from_string_bench)
+   const std::string str = "cyber.token";
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(name(std::string_view(str)).value);
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(name_to_string_bench)
+   const name n = "cyber.token"_n;
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(n.to_string());
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(name_length_bench)
+   const name n = "cyber.token"_n;
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(n.length());
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(name_suffix_bench)
+   const name n = "cyber.token"_n;
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(n.suffix().value);
+   }
+EOSIO_BENCH_END
+
+int main(int argc, char* argv[]) {
+   if (!parse_bench_args(argc, argv))
+      return -1;
+
+   EOSIO_BENCH(name_from_string_bench);
+   EOSIO_BENCH(name_to_string_bench);
+   EOSIO_BENCH(name_length_bench);
+   EOSIO_BENCH(name_suffix_bench);
+   return has_failed();
+}
@@ -0,0 +1,65 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+
+#include <eosio/eosio.hpp>
+#include <eosio/rope.hpp>
+#include <eosio/bench.hpp>
+
+using namespace eosio::native;
+
+EOSIO_BENCH_BEGIN(rope_append_bench)
+   EOSIO_BENCH_LOOP {
+      eosio::rope r("test string 0");
+      for (int i = 0; i < 8; ++i) {
+         r += ", test string";
+      }
+      do_not_optimize(r.length());
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(string_append_bench)
+   EOSIO_BENCH_LOOP {
+      std::string s("test string 0");
+      for (int i = 0; i < 8; ++i) {
+         s += ", test string";
+      }
+      do_not_optimize(s.length());
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(rope_c_str_bench)
+   eosio::rope r("test string 0");
+   for (int i = 0; i < 8; ++i) {
+      r += ", test string";
+   }
+   EOSIO_BENCH_LOOP {
+      char* s = r.c_str();
+      do_not_optimize(s[0]);
+      delete[] s;
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(rope_index_bench)
+   eosio::rope r("test string 0");
+   for (int i = 0; i < 8; ++i) {
+      r += ", test string";
+   }
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(r[r.length() / 2]);
+   }
+EOSIO_BENCH_END
+
+int main(int argc, char* argv[]) {
+   if (!parse_bench_args(argc, argv))
+      return -1;
+
+   EOSIO_BENCH(rope_append_bench);
+   EOSIO_BENCH(string_append_bench);
+   EOSIO_BENCH(rope_c_str_bench);
+   EOSIO_BENCH(rope_index_bench);
+   return has_failed();
+}
@@ -0,0 +1,50 @@
+# Builds the contract of several files serially, with -j 2, and with -j 2 from the cache of the serial build:
+# the wasm and the abi must be the same. The object files of the serial and the parallel builds, which are kept
+# in their caches under the same keys, must be the same too: both inputs declare the actions of the contract.
+#
+# cmake -DCYBERWAY_CPP=<path> -DSOURCE_DIR=<dir> -DBINARY_DIR=<dir> -P compare_parallel_build.cmake
+
+set(SOURCES ${SOURCE_DIR}/multi_file_accounts.cpp ${SOURCE_DIR}/multi_file_stats.cpp)
+set(CACHE_DIR ${BINARY_DIR}/multi_file_cache)
+set(PARALLEL_CACHE_DIR ${BINARY_DIR}/multi_file_parallel_cache)
+file(REMOVE_RECURSE ${CACHE_DIR} ${PARALLEL_CACHE_DIR})
+
+function(build NAME)
+   execute_process(COMMAND ${CYBERWAY_CPP} -abigen -contract=multi_file ${ARGN} -o ${BINARY_DIR}/${NAME}.wasm ${SOURCES}
+                   RESULT_VARIABLE result)
+   if(NOT result EQUAL 0)
+      message(FATAL_ERROR "${NAME}: cyberway-cpp failed")
+   endif()
+endfunction()
+
+function(compare NAME)
+   foreach(ext wasm abi)
+      execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${BINARY_DIR}/multi_file_serial.${ext} ${BINARY_DIR}/${NAME}.${ext}
+                      RESULT_VARIABLE result)
+      if(NOT result EQUAL 0)
+         message(FATAL_ERROR "${NAME}.${ext} differs from the serial build")
+      endif()
+   endforeach()
+endfunction()
+
+function(compare_objects)
+   file(GLOB serial_objects RELATIVE ${CACHE_DIR} ${CACHE_DIR}/*.o)
+   list(LENGTH serial_objects count)
+   if(NOT count EQUAL 2)
+      message(FATAL_ERROR "the serial build cached ${count} object files instead of 2")
+   endif()
+   foreach(object ${serial_objects})
+      execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${CACHE_DIR}/${object} ${PARALLEL_CACHE_DIR}/${object}
+                      RESULT_VARIABLE result)
+      if(NOT result EQUAL 0)
+         message(FATAL_ERROR "the object file ${object} of the parallel build differs from the serial build")
+      endif()
+   endforeach()
+endfunction()
+
+build(multi_file_serial -j=1 -cache-dir=${CACHE_DIR})
+build(multi_file_parallel -j=2 -cache-dir=${PARALLEL_CACHE_DIR})
+build(multi_file_cached -j=2 -cache-dir=${CACHE_DIR})
+compare(multi_file_parallel)
+compare(multi_file_cached)
+compare_objects()
@@ -0,0 +1,30 @@
+# Links the contract without the post pass and runs eosio-pp over it, then links it with the post pass of eosio-ld:
+# the two wasm must be the same, with the default options and with -fkeep-names and another segment gap.
+#
+# cmake -DBIN_DIR=<dir> -DSOURCE_DIR=<dir> -DBINARY_DIR=<dir> -P compare_post_pass.cmake
+
+set(OBJECT ${BINARY_DIR}/post_pass_transfer.o)
+
+function(run NAME)
+   execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+   if(NOT result EQUAL 0)
+      message(FATAL_ERROR "${NAME} failed")
+   endif()
+endfunction()
+
+# <name> <eosio-ld options> PP <eosio-pp options>
+function(compare NAME)
+   cmake_parse_arguments(ARG "" "" "LD;PP" ${ARGN})
+   set(prefix ${BINARY_DIR}/post_pass_${NAME})
+   run("${NAME}: eosio-ld -fno-post-pass" ${BIN_DIR}/eosio-ld ${OBJECT} -o ${prefix}_raw.wasm -fno-post-pass ${ARG_LD})
+   run("${NAME}: eosio-pp" ${BIN_DIR}/eosio-pp ${prefix}_raw.wasm -o ${prefix}_pp.wasm ${ARG_PP})
+   run("${NAME}: eosio-ld" ${BIN_DIR}/eosio-ld ${OBJECT} -o ${prefix}_ld.wasm ${ARG_LD})
+   execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${prefix}_pp.wasm ${prefix}_ld.wasm RESULT_VARIABLE result)
+   if(NOT result EQUAL 0)
+      message(FATAL_ERROR "${NAME}: the post pass of eosio-ld differs from eosio-pp")
+   endif()
+endfunction()
+
+run("cyberway-cpp -c" ${BIN_DIR}/cyberway-cpp -c ${SOURCE_DIR}/transfer.cpp -o ${OBJECT})
+compare(default)
+compare(keep_names LD -fkeep-names -data-segment-gap=0 PP --keep-names -g 0)
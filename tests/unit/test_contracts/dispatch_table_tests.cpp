@@ -0,0 +1,52 @@
+#include <eosio/eosio.hpp>
+
+#include "transfer.hpp"
+
+using namespace eosio;
+
+// Built with -fdispatch-table, so the apply is the binary search generated by the codegen
+class [[eosio::contract]] dispatch_table_tests : public contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]]
+      void test1(name nm) {
+         check(nm == "bucky"_n, "not bucky");
+      }
+
+      [[eosio::action]]
+      void test2(int arg0, std::string arg1) {
+         check(arg0 == 33, "33 does not match");
+         check(arg1 == "some string", "some string does not match");
+      }
+
+      [[eosio::action]]
+      void sendtransfer(std::string memo) {
+         transfer_contract::transfer_action trans("eosio.token"_n, {_self, "active"_n});
+         trans.send(_self, "someone"_n, asset{100, {"TST", 4}}, memo);
+      }
+
+      [[eosio::action]]
+      void sendtrans2(std::string memo) {
+         transfer_contract::transfer2_action trans("someone"_n, {_self, "active"_n});
+         trans.send(_self, "other"_n, asset{100, {"TST", 4}}, memo);
+      }
+
+      [[eosio::action]]
+      void sendtrans3(std::string memo) {
+         transfer_contract::transfer3_action trans("someone"_n, {_self, "active"_n});
+         trans.send(_self, "other"_n, asset{100, {"TST", 4}}, memo);
+      }
+
+      [[eosio::on_notify("eosio.token::transfer")]]
+      void on_transfer(name from, name to, asset quant, std::string memo) {
+         check(get_first_receiver() == "eosio.token"_n, "should be eosio.token");
+         check(memo != "fail", "on_transfer failed");
+      }
+
+      [[eosio::on_notify("*::transfer2")]]
+      void on_transfer2(name from, name to, asset quant, std::string memo) {
+         check(get_first_receiver() == "someone"_n, "should be someone");
+         check(memo != "fail", "on_transfer2 failed");
+      }
+};
@@ -0,0 +1,77 @@
+#include <eosio/eosio.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace eosio;
+
+// The same allocation traces are built with each malloc implementation:
+//    malloc_bench            - the default non-freeing malloc (eosio_dsm)
+//    old_malloc_bench        - the freeing malloc (eosio_malloc, --use-freeing-malloc)
+//    size_class_malloc_bench - the size-class malloc (eosio_size_class_malloc, --use-size-class-malloc)
+// The total size of allocations of each trace is kept below the memory limit of the non-freeing malloc.
+CONTRACT malloc_bench : public contract {
+   public:
+      using contract::contract;
+
+      // Deterministic pseudo-random sizes and lifetimes
+      struct lcg {
+         uint32_t state;
+         uint32_t operator()(uint32_t bound) {
+            state = state * 1664525 + 1013904223;
+            return (state >> 8) % bound;
+         }
+      };
+
+      static void report(const char* trace) {
+         print(trace, ": ", __builtin_wasm_current_memory(), " pages\n");
+      }
+
+      // Growing vectors: the pattern of serialization buffers and action arguments
+      ACTION vectors(uint32_t rounds) {
+         uint64_t sum = 0;
+         for (uint32_t r = 0; r < rounds; ++r) {
+            std::vector<uint64_t> values;
+            for (uint64_t i = 0; i < 64 + r % 192; ++i) {
+               values.push_back(i);
+            }
+            sum += values.back();
+         }
+         check(sum > 0, "vectors trace is broken");
+         report("vectors");
+      }
+
+      // Node-based containers with insertions and erases: the pattern of contract state processing
+      ACTION maps(uint32_t count) {
+         std::map<uint64_t, std::string> table;
+         lcg rnd{count};
+         for (uint32_t i = 0; i < count; ++i) {
+            table[rnd(count * 4)] = std::string(8 + rnd(56), 'x');
+            if (i % 3 == 2) {
+               table.erase(table.begin());
+            }
+         }
+         check(!table.empty(), "maps trace is broken");
+         report("maps");
+      }
+
+      // Short-lived blocks of mixed sizes with a window of live objects
+      ACTION mixed(uint32_t count, uint32_t window) {
+         check(window > 0, "window must be positive");
+         std::vector<char*> live(window, nullptr);
+         lcg rnd{count ^ window};
+         for (uint32_t i = 0; i < count; ++i) {
+            auto& slot = live[rnd(window)];
+            free(slot);
+            const uint32_t size = rnd(8) == 0 ? 256 + rnd(4096) : 8 + rnd(120);
+            slot = static_cast<char*>(malloc(size));
+            check(slot != nullptr, "mixed trace is broken");
+            slot[0] = slot[size - 1] = char(i);
+         }
+         for (auto ptr: live) {
+            free(ptr);
+         }
+         report("mixed");
+      }
+};
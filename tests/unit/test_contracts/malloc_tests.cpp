@@ -88,4 +88,58 @@ CONTRACT malloc_tests : public contract{
           check(ptr4 != nullptr, "should have allocated another 20 char buf");
           check(ptr3 + 20 < ptr4, "20 char buf should have been created after ptr1"); // test specific to implementation (can remove for refactor)
       }
+
+      // realloc keeps the contents when the buffer grows and when it shrinks
+      ACTION reallocgrow() {
+         char* ptr = (char*)malloc(24);
+         for (int i = 0; i < 24; i++) {
+            ptr[i] = char(i);
+         }
+         ptr = (char*)realloc(ptr, 1000);
+         check(ptr != nullptr, X("should have grown the buf"));
+         for (int i = 0; i < 24; i++) {
+            check(ptr[i] == char(i), X("realloc should have kept the contents"));
+         }
+         ptr = (char*)realloc(ptr, 8);
+         check(ptr != nullptr, X("should have shrunk the buf"));
+         for (int i = 0; i < 8; i++) {
+            check(ptr[i] == char(i), X("realloc should have kept the contents"));
+         }
+         free(ptr);
+      }
+
+      ACTION calloczero() {
+         // a freed buf may be reused by calloc, which must clear it
+         char* dirty = (char*)malloc(64);
+         memset(dirty, 0xff, 64);
+         free(dirty);
+         char* ptr = (char*)calloc(16, 4);
+         check(ptr != nullptr, X("should have allocated a 64 char buf"));
+         for (int i = 0; i < 64; i++) {
+            check(ptr[i] == 0, X("calloc should have zeroed the buf"));
+         }
+         check(calloc(size_t(-1)/2, 4) == nullptr, X("calloc should have failed on the overflow"));
+      }
+
+      // the following actions are specific to the size-class malloc
+      ACTION freereuse() {
+         char* ptr1 = (char*)malloc(100);
+         free(ptr1);
+         char* ptr2 = (char*)malloc(100);
+         check(ptr2 == ptr1, X("the freed buf should have been reused"));
+         free(ptr2);
+         char* ptr3 = (char*)malloc(70);
+         check(ptr3 == ptr1, X("the freed buf should have been reused by a request of its class"));
+         char* ptr4 = (char*)malloc(100);
+         check(ptr4 != ptr3, X("a buf in use should not have been reused"));
+      }
+
+      ACTION powoftwo() {
+         // a 2^k request fits a block of the 2^k class, the next block follows its header
+         char* ptr1 = (char*)malloc(64);
+         char* ptr2 = (char*)malloc(64);
+         check(ptr2 - ptr1 == 64 + 8, X("malloc(64) should have taken a block of the 64 bytes class"));
+         char* ptr3 = (char*)realloc(ptr1, 64);
+         check(ptr3 == ptr1, X("realloc to the capacity of the buf should have kept it"));
+      }
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+// A contract of several files, every file declares its own table
+CONTRACT multi_file : public contract {
+   public:
+      using contract::contract;
+
+      ACTION open(name owner);
+      ACTION setsupply(uint64_t supply);
+};
@@ -0,0 +1,15 @@
+#include "multi_file.hpp"
+
+TABLE account {
+   name     owner;
+   uint64_t balance = 0;
+
+   uint64_t primary_key() const { return owner.value; }
+};
+
+using accounts = multi_index<"accounts"_n, account>;
+
+void multi_file::open(name owner) {
+   accounts table(get_self(), get_self().value);
+   table.emplace(get_self(), [&](auto& a) { a.owner = owner; });
+}
@@ -0,0 +1,15 @@
+#include "multi_file.hpp"
+
+TABLE stat {
+   uint64_t id     = 0;
+   uint64_t supply = 0;
+
+   uint64_t primary_key() const { return id; }
+};
+
+using stats = multi_index<"stats"_n, stat>;
+
+void multi_file::setsupply(uint64_t supply) {
+   stats table(get_self(), get_self().value);
+   table.emplace(get_self(), [&](auto& s) { s.supply = supply; });
+}
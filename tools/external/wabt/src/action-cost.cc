@@ -0,0 +1,294 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "src/action-cost.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "src/binary-reader.h"
+#include "src/binary-reader-nop.h"
+#include "src/cast.h"
+#include "src/ir.h"
+
+namespace wabt {
+
+namespace {
+
+class BodySizeReader : public BinaryReaderNop {
+ public:
+  explicit BodySizeReader(std::vector<Offset>* sizes) : sizes_(sizes) {}
+
+  Result OnFunctionCount(Index count) override {
+    sizes_->resize(sizes_->size() + count);
+    return Result::Ok;
+  }
+  Result OnImportFunc(Index import_index,
+                      string_view module_name,
+                      string_view field_name,
+                      Index func_index,
+                      Index sig_index) override {
+    sizes_->push_back(0);
+    return Result::Ok;
+  }
+  Result BeginFunctionBody(Index index) override {
+    start_ = state->offset;
+    return Result::Ok;
+  }
+  Result EndFunctionBody(Index index) override {
+    (*sizes_)[index] = state->offset - start_;
+    return Result::Ok;
+  }
+
+ private:
+  std::vector<Offset>* sizes_;
+  Offset start_ = 0;
+};
+
+struct CallSite {
+  Index callee;
+  Index loop_depth;
+};
+
+struct FuncCost {
+  Index instructions = 0;
+  Index loops = 0;
+  Index loop_depth = 0;
+  Index indirect_calls = 0;
+  std::vector<CallSite> calls;
+};
+
+void AnalyzeExprs(const ExprList& exprs, Index loop_depth, FuncCost* cost);
+
+void AnalyzeBlock(const Block& block, Index loop_depth, FuncCost* cost) {
+  AnalyzeExprs(block.exprs, loop_depth, cost);
+}
+
+void AnalyzeExprs(const ExprList& exprs, Index loop_depth, FuncCost* cost) {
+  for (const Expr& expr : exprs) {
+    cost->instructions++;
+    switch (expr.type()) {
+      case ExprType::Block:
+        AnalyzeBlock(cast<BlockExpr>(&expr)->block, loop_depth, cost);
+        break;
+
+      case ExprType::Loop:
+        cost->loops++;
+        cost->loop_depth = std::max(cost->loop_depth, loop_depth + 1);
+        AnalyzeBlock(cast<LoopExpr>(&expr)->block, loop_depth + 1, cost);
+        break;
+
+      case ExprType::If: {
+        auto if_expr = cast<IfExpr>(&expr);
+        AnalyzeBlock(if_expr->true_, loop_depth, cost);
+        AnalyzeExprs(if_expr->false_, loop_depth, cost);
+        break;
+      }
+
+      case ExprType::IfExcept: {
+        auto if_except_expr = cast<IfExceptExpr>(&expr);
+        AnalyzeBlock(if_except_expr->true_, loop_depth, cost);
+        AnalyzeExprs(if_except_expr->false_, loop_depth, cost);
+        break;
+      }
+
+      case ExprType::Try: {
+        auto try_expr = cast<TryExpr>(&expr);
+        AnalyzeBlock(try_expr->block, loop_depth, cost);
+        AnalyzeExprs(try_expr->catch_, loop_depth, cost);
+        break;
+      }
+
+      case ExprType::Call:
+        cost->calls.push_back(
+            CallSite{cast<CallExpr>(&expr)->var.index(), loop_depth});
+        break;
+
+      case ExprType::CallIndirect:
+        cost->indirect_calls++;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+class CostCalculator {
+ public:
+  CostCalculator(const Module& module, const std::vector<Offset>& body_sizes);
+
+  void Compute(Index entry, ActionCost* cost);
+
+ private:
+  void FindComponent(Index func_index);
+
+  const Module& module_;
+  const std::vector<Offset>& body_sizes_;
+  std::vector<FuncCost> funcs_;
+  std::vector<std::string> import_names_;
+
+  // The strongly connected components of the call graph (Tarjan), computed
+  // once for all actions. A component is found after the components it calls,
+  // so their nested loop depths are known by then.
+  std::vector<Index> component_;   // per function
+  std::vector<Index> order_;       // per function, kInvalidIndex if not seen
+  std::vector<Index> low_;         // per function
+  std::vector<bool> on_stack_;     // per function
+  std::vector<Index> stack_;
+  Index next_order_ = 0;
+  std::vector<bool> cyclic_;       // per component, has a cycle of calls
+  std::vector<Index> loop_depth_;  // per component, nested across calls
+};
+
+CostCalculator::CostCalculator(const Module& module,
+                               const std::vector<Offset>& body_sizes)
+    : module_(module),
+      body_sizes_(body_sizes),
+      funcs_(module.funcs.size()),
+      component_(module.funcs.size(), kInvalidIndex),
+      order_(module.funcs.size(), kInvalidIndex),
+      low_(module.funcs.size(), kInvalidIndex),
+      on_stack_(module.funcs.size(), false) {
+  for (const Import* import : module.imports) {
+    if (import->kind() == ExternalKind::Func) {
+      import_names_.push_back(import->field_name);
+    }
+  }
+  for (Index i = module.num_func_imports; i < module.funcs.size(); ++i) {
+    AnalyzeExprs(module.funcs[i]->exprs, 0, &funcs_[i]);
+  }
+  for (Index i = 0; i < module.funcs.size(); ++i) {
+    if (order_[i] == kInvalidIndex) {
+      FindComponent(i);
+    }
+  }
+}
+
+void CostCalculator::FindComponent(Index func_index) {
+  order_[func_index] = low_[func_index] = next_order_++;
+  stack_.push_back(func_index);
+  on_stack_[func_index] = true;
+  for (const CallSite& call : funcs_[func_index].calls) {
+    if (order_[call.callee] == kInvalidIndex) {
+      FindComponent(call.callee);
+      low_[func_index] = std::min(low_[func_index], low_[call.callee]);
+    } else if (on_stack_[call.callee]) {
+      low_[func_index] = std::min(low_[func_index], order_[call.callee]);
+    }
+  }
+  if (low_[func_index] != order_[func_index]) {
+    return;
+  }
+
+  Index component = cyclic_.size();
+  std::vector<Index> members;
+  Index member;
+  do {
+    member = stack_.back();
+    stack_.pop_back();
+    on_stack_[member] = false;
+    component_[member] = component;
+    members.push_back(member);
+  } while (member != func_index);
+
+  // a cycle is followed once: the deepest call site inside of the cycle
+  // encloses the deepest loops of its members and of the calls out of it,
+  // the depth of the recursion is unknown anyway
+  bool cyclic = members.size() > 1;
+  Index cycle_depth = 0;
+  Index depth = 0;
+  for (Index index : members) {
+    const FuncCost& func = funcs_[index];
+    depth = std::max(depth, func.loop_depth);
+    for (const CallSite& call : func.calls) {
+      Index callee = component_[call.callee];
+      if (callee == component) {
+        cyclic = true;
+        cycle_depth = std::max(cycle_depth, call.loop_depth);
+      } else {
+        depth = std::max(depth, call.loop_depth + loop_depth_[callee]);
+      }
+    }
+  }
+  depth += cycle_depth;
+  cyclic_.push_back(cyclic);
+  loop_depth_.push_back(depth);
+}
+
+void CostCalculator::Compute(Index entry, ActionCost* cost) {
+  std::set<Index> visited{entry};
+  std::vector<Index> worklist{entry};
+  while (!worklist.empty()) {
+    Index index = worklist.back();
+    worklist.pop_back();
+    const FuncCost& func = funcs_[index];
+    cost->functions++;
+    cost->instructions += func.instructions;
+    cost->code_size += index < body_sizes_.size() ? body_sizes_[index] : 0;
+    cost->loops += func.loops;
+    cost->indirect_calls += func.indirect_calls;
+    cost->recursive |= cyclic_[component_[index]];
+    for (const CallSite& call : func.calls) {
+      if (call.callee < module_.num_func_imports) {
+        cost->host_calls[import_names_[call.callee]]++;
+      } else if (visited.insert(call.callee).second) {
+        worklist.push_back(call.callee);
+      }
+    }
+  }
+  cost->loop_depth = loop_depth_[component_[entry]];
+}
+
+}  // end anonymous namespace
+
+Result ReadFunctionBodySizes(const void* data,
+                             size_t size,
+                             const ReadBinaryOptions* options,
+                             std::vector<Offset>* out_sizes) {
+  BodySizeReader reader(out_sizes);
+  return ReadBinary(data, size, &reader, options);
+}
+
+void ComputeActionCosts(const Module& module,
+                        const std::vector<Offset>& body_sizes,
+                        std::vector<ActionCost>* out_costs) {
+  static const std::pair<const char*, const char*> kEntries[] = {
+      {"$__eosio_action_", "action"},
+      {"$__eosio_notify_", "notify"},
+  };
+
+  CostCalculator calculator(module, body_sizes);
+  for (Index i = module.num_func_imports; i < module.funcs.size(); ++i) {
+    const std::string& name = module.funcs[i]->name;
+    for (const auto& entry : kEntries) {
+      string_view prefix(entry.first);
+      if (name.compare(0, prefix.size(), prefix.data(), prefix.size()) != 0) {
+        continue;
+      }
+      ActionCost cost;
+      cost.kind = entry.second;
+      cost.name = name.substr(prefix.size());
+      cost.func_index = i;
+      calculator.Compute(i, &cost);
+      out_costs->push_back(std::move(cost));
+    }
+  }
+}
+
+}  // namespace wabt
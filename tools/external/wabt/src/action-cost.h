@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WABT_ACTION_COST_H_
+#define WABT_ACTION_COST_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/common.h"
+
+namespace wabt {
+
+struct Module;
+struct ReadBinaryOptions;
+
+// Static cost of the code reachable from an action or a notify handler, the
+// __eosio_action_*/__eosio_notify_* functions generated by cyberway-cpp.
+struct ActionCost {
+  std::string kind;      // "action" or "notify"
+  std::string name;      // the function name without the prefix
+  Index func_index = kInvalidIndex;
+
+  Index functions = 0;       // defined functions reachable by direct calls
+  Index instructions = 0;    // static instruction count of those functions
+  Offset code_size = 0;      // bytes of their bodies in the code section
+  Index loops = 0;
+  Index loop_depth = 0;      // the deepest nesting of loops, across calls;
+                             // a cycle of calls is followed once
+  Index indirect_calls = 0;  // call_indirect sites, their targets are unknown
+  bool recursive = false;    // the call graph has a cycle
+  std::map<std::string, Index> host_calls;  // import name -> call sites
+};
+
+// Sizes of the function bodies, indexed by the function index (the imports
+// have size 0).
+Result ReadFunctionBodySizes(const void* data,
+                             size_t size,
+                             const ReadBinaryOptions* options,
+                             std::vector<Offset>* out_sizes);
+
+// The entries are found by the function names, so the module must be read
+// with the names (linked with -fkeep-names).
+void ComputeActionCosts(const Module& module,
+                        const std::vector<Offset>& body_sizes,
+                        std::vector<ActionCost>* out_costs);
+
+}  // namespace wabt
+
+#endif /* WABT_ACTION_COST_H_ */
@@ -216,6 +216,9 @@ class BinaryReaderInterp : public BinaryReaderNop {
   wabt::Result OnInitExprI32ConstExpr(Index index, uint32_t value) override;
   wabt::Result OnInitExprI64ConstExpr(Index index, uint64_t value) override;
 
+  wabt::Result OnFunctionName(Index function_index,
+                              string_view function_name) override;
+
  private:
   Label* GetLabel(Index depth);
   Label* TopLabel();
@@ -1058,6 +1061,17 @@ wabt::Result BinaryReaderInterp::OnElemSegmentFunctionIndex(Index index,
   return wabt::Result::Ok;
 }
 
+wabt::Result BinaryReaderInterp::OnFunctionName(Index function_index,
+                                               string_view function_name) {
+  if (function_index < func_index_mapping_.size()) {
+    Func* func = GetFuncByModuleIndex(function_index);
+    if (!func->is_host) {
+      cast<DefinedFunc>(func)->name = function_name.to_string();
+    }
+  }
+  return wabt::Result::Ok;
+}
+
 wabt::Result BinaryReaderInterp::OnDataSegmentData(Index index,
                                                    const void* src_data,
                                                    Address size) {
@@ -1409,6 +1409,9 @@ bool Environment::FuncSignaturesAreEqual(Index sig_index_0,
 
 Result Thread::CallHost(HostFunc* func) {
   FuncSignature* sig = &env_->sigs_[func->sig_index];
+  if (profiler_) {
+    profiler_->OnHostCall(func);
+  }
 
   size_t num_params = sig->param_types.size();
   size_t num_results = sig->result_types.size();
@@ -1557,7 +1560,7 @@ Result Thread::Run(int num_instructions) {
         TRAP_UNLESS(env_->FuncSignaturesAreEqual(func->sig_index, sig_index),
                     IndirectCallSignatureMismatch);
         if (func->is_host) {
-          CallHost(cast<HostFunc>(func));
+          CHECK_TRAP(CallHost(cast<HostFunc>(func)));
         } else {
           CHECK_TRAP(PushCall(pc));
           GOTO(cast<DefinedFunc>(func)->offset);
@@ -1567,7 +1570,7 @@ Result Thread::Run(int num_instructions) {
 
       case Opcode::InterpCallHost: {
         Index func_index = ReadU32(&pc);
-        CallHost(cast<HostFunc>(env_->funcs_[func_index].get()));
+        CHECK_TRAP(CallHost(cast<HostFunc>(env_->funcs_[func_index].get())));
         break;
       }
 
@@ -4428,6 +4431,131 @@ void Environment::DisassembleModule(Stream* stream, Module* module) {
               defined_module->istream_end);
 }
 
+Profiler::Profiler(Environment* env) : env_(env) {
+  for (Index i = 0; i < env_->GetFuncCount(); ++i) {
+    Func* func = env_->GetFunc(i);
+    if (!func->is_host) {
+      func_by_offset_[cast<DefinedFunc>(func)->offset] = i;
+    }
+  }
+  nodes_.emplace_back(kInvalidIndex, kInvalidIndex);
+}
+
+void Profiler::EnterFunc(IstreamOffset offset) {
+  auto iter = func_by_offset_.find(offset);
+  assert(iter != func_by_offset_.end());
+  Index func_index = iter->second;
+  auto child = nodes_[current_].children.find(func_index);
+  if (child == nodes_[current_].children.end()) {
+    nodes_.emplace_back(func_index, current_);
+    child = nodes_[current_].children.emplace(func_index, nodes_.size() - 1)
+                .first;
+  }
+  current_ = child->second;
+  nodes_[current_].calls++;
+}
+
+void Profiler::LeaveFunc() {
+  assert(current_ != 0);
+  current_ = nodes_[current_].parent;
+}
+
+void Profiler::OnHostCall(const HostFunc* func) {
+  nodes_[current_].host_calls[func->module_name + "." + func->field_name]++;
+}
+
+std::string Profiler::GetFuncName(Index func_index) const {
+  const Func* func = env_->GetFunc(func_index);
+  if (!func->is_host && !cast<DefinedFunc>(func)->name.empty()) {
+    return cast<DefinedFunc>(func)->name;
+  }
+  return StringPrintf("func[%" PRIindex "]", func_index);
+}
+
+std::string Profiler::GetStack(Index node) const {
+  std::string stack = GetFuncName(nodes_[node].func_index);
+  for (Index i = nodes_[node].parent; i != 0; i = nodes_[i].parent) {
+    stack = GetFuncName(nodes_[i].func_index) + ";" + stack;
+  }
+  return stack;
+}
+
+uint64_t Profiler::GetTotalInstructions(Index node) const {
+  uint64_t total = nodes_[node].instructions;
+  for (const auto& child : nodes_[node].children) {
+    total += GetTotalInstructions(child.second);
+  }
+  return total;
+}
+
+void Profiler::WriteFoldedStacks(Stream* stream) const {
+  for (Index i = 1; i < nodes_.size(); ++i) {
+    std::string stack = GetStack(i);
+    if (nodes_[i].instructions) {
+      stream->Writef("%s %" PRIu64 "\n", stack.c_str(),
+                     nodes_[i].instructions);
+    }
+    // The host functions are leaves weighted by the number of calls.
+    for (const auto& host_call : nodes_[i].host_calls) {
+      stream->Writef("%s;%s %" PRIu64 "\n", stack.c_str(),
+                     host_call.first.c_str(), host_call.second);
+    }
+  }
+}
+
+void Profiler::WriteSummary(Stream* stream) const {
+  struct FuncSummary {
+    uint64_t self = 0;
+    uint64_t total = 0;
+    uint64_t calls = 0;
+    std::map<std::string, uint64_t> host_calls;
+  };
+
+  std::map<Index, FuncSummary> funcs;
+  for (Index i = 1; i < nodes_.size(); ++i) {
+    const Node& node = nodes_[i];
+    FuncSummary& summary = funcs[node.func_index];
+    summary.self += node.instructions;
+    summary.calls += node.calls;
+    for (const auto& host_call : node.host_calls) {
+      summary.host_calls[host_call.first] += host_call.second;
+    }
+    // Count the total of the recursive calls once, at the outermost call.
+    bool outermost = true;
+    for (Index j = node.parent; j != 0; j = nodes_[j].parent) {
+      if (nodes_[j].func_index == node.func_index) {
+        outermost = false;
+        break;
+      }
+    }
+    if (outermost) {
+      summary.total += GetTotalInstructions(i);
+    }
+  }
+
+  std::vector<std::pair<Index, const FuncSummary*>> sorted;
+  for (const auto& func : funcs) {
+    sorted.emplace_back(func.first, &func.second);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const std::pair<Index, const FuncSummary*>& a,
+                      const std::pair<Index, const FuncSummary*>& b) {
+                     return a.second->total > b.second->total;
+                   });
+
+  stream->Writef("%12s %12s %8s  %s\n", "self", "total", "calls", "function");
+  for (const auto& func : sorted) {
+    const FuncSummary* summary = func.second;
+    stream->Writef("%12" PRIu64 " %12" PRIu64 " %8" PRIu64 "  %s\n",
+                   summary->self, summary->total, summary->calls,
+                   GetFuncName(func.first).c_str());
+    for (const auto& host_call : summary->host_calls) {
+      stream->Writef("%12s %12s %8" PRIu64 "    -> %s\n", "", "",
+                     host_call.second, host_call.first.c_str());
+    }
+  }
+}
+
 Executor::Executor(Environment* env,
                    Stream* trace_stream,
                    const Thread::Options& options)
@@ -4493,7 +4621,26 @@ ExecResult Executor::RunExportByName(Module* module,
 Result Executor::RunDefinedFunction(IstreamOffset function_offset) {
   Result result = Result::Ok;
   thread_.set_pc(function_offset);
-  if (trace_stream_) {
+  if (profiler_) {
+    // One instruction at a time, a call or a return changes the depth of the
+    // call stack.
+    Index caller = profiler_->current();
+    profiler_->EnterFunc(function_offset);
+    while (result == Result::Ok) {
+      if (trace_stream_) {
+        thread_.Trace(trace_stream_);
+      }
+      uint32_t depth = thread_.call_stack_depth();
+      profiler_->OnInstruction();
+      result = thread_.Run(1);
+      if (thread_.call_stack_depth() > depth) {
+        profiler_->EnterFunc(thread_.pc());
+      } else if (thread_.call_stack_depth() < depth) {
+        profiler_->LeaveFunc();
+      }
+    }
+    profiler_->Unwind(caller);
+  } else if (trace_stream_) {
     const int kNumInstructions = 1;
     while (result == Result::Ok) {
       thread_.Trace(trace_stream_);
@@ -20,7 +20,9 @@
 #include <stdint.h>
 
 #include <functional>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "src/binding-hash.h"
@@ -250,6 +252,7 @@ struct DefinedFunc : Func {
   Index local_decl_count;
   Index local_count;
   std::vector<Type> param_and_local_types;
+  std::string name;  // from the name section, if any
 };
 
 struct HostFunc : Func {
@@ -463,6 +466,8 @@ class Environment {
   BindingHash registered_module_bindings_;
 };
 
+class Profiler;
+
 class Thread {
  public:
   struct Options {
@@ -482,6 +487,8 @@ class Thread {
 
   void set_pc(IstreamOffset offset) { pc_ = offset; }
   IstreamOffset pc() const { return pc_; }
+  uint32_t call_stack_depth() const { return call_stack_top_; }
+  void set_profiler(Profiler* profiler) { profiler_ = profiler; }
 
   void Reset();
   Index NumValues() const { return value_stack_top_; }
@@ -568,6 +575,52 @@ class Thread {
   uint32_t value_stack_top_ = 0;
   uint32_t call_stack_top_ = 0;
   IstreamOffset pc_ = 0;
+  Profiler* profiler_ = nullptr;
+};
+
+// Counts the executed instructions and the host calls per call stack of the
+// defined functions. The executor runs the functions instruction by
+// instruction while a profiler is set, see Executor::set_profiler.
+class Profiler {
+ public:
+  explicit Profiler(Environment*);
+
+  void EnterFunc(IstreamOffset offset);
+  void LeaveFunc();
+  void OnInstruction() { nodes_[current_].instructions++; }
+  void OnHostCall(const HostFunc*);
+
+  // The current call stack, to be restored after a trap.
+  Index current() const { return current_; }
+  void Unwind(Index node) { current_ = node; }
+
+  // One line per call stack, "outer;inner <instructions>", the folded stacks
+  // format of flamegraph.pl and the other flame graph tools.
+  void WriteFoldedStacks(Stream*) const;
+  // Self and total instructions, calls and host calls of each function.
+  void WriteSummary(Stream*) const;
+
+ private:
+  struct Node {
+    Node(Index func_index, Index parent)
+        : func_index(func_index), parent(parent) {}
+
+    Index func_index;
+    Index parent;
+    uint64_t instructions = 0;
+    uint64_t calls = 0;
+    std::map<Index, Index> children;        // func index -> node
+    std::map<std::string, uint64_t> host_calls;  // host function -> calls
+  };
+
+  std::string GetFuncName(Index func_index) const;
+  std::string GetStack(Index node) const;
+  uint64_t GetTotalInstructions(Index node) const;
+
+  Environment* env_;
+  std::map<IstreamOffset, Index> func_by_offset_;
+  std::vector<Node> nodes_;  // the first node is the root, outside of calls
+  Index current_ = 0;
 };
 
 struct ExecResult {
@@ -593,6 +646,11 @@ class Executor {
                              string_view name,
                              const TypedValues& args);
 
+  void set_profiler(Profiler* profiler) {
+    profiler_ = profiler;
+    thread_.set_profiler(profiler);
+  }
+
  private:
   Result RunDefinedFunction(IstreamOffset function_offset);
   Result PushArgs(const FuncSignature*, const TypedValues& args);
@@ -600,6 +658,7 @@ class Executor {
 
   Environment* env_ = nullptr;
   Stream* trace_stream_ = nullptr;
+  Profiler* profiler_ = nullptr;
   Thread thread_;
 };
 
@@ -0,0 +1,483 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "src/postpass.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "src/binary-reader.h"
+#include "src/binary-reader-ir.h"
+#include "src/binary-writer.h"
+#include "src/cast.h"
+#include "src/error-handler.h"
+#include "src/expr-visitor.h"
+#include "src/ir.h"
+#include "src/make-unique.h"
+#include "src/stream.h"
+
+namespace wabt {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// Initial value of a global initialized by an i32.const expression.
+bool GetConstGlobalInit(const Module& module, Index index, uint32_t* value) {
+  const ExprList& init = module.globals[index]->init_expr;
+  if (init.size() != 1 || init.front().type() != ExprType::Const) {
+    return false;
+  }
+  const Const& init_value = cast<ConstExpr>(&init.front())->const_;
+  if (init_value.type != Type::I32) {
+    return false;
+  }
+  *value = init_value.u32;
+  return true;
+}
+
+void StripZeroedData(Module* module) {
+  std::vector<DataSegment*> segments;
+  for (DataSegment* segment : module->data_segments) {
+    bool is_zeroed = true;
+    for (uint8_t datum : segment->data) {
+      is_zeroed &= datum == 0;
+    }
+    if (!is_zeroed) {
+      segments.push_back(segment);
+    }
+  }
+  module->data_segments = segments;
+}
+
+void AddHeapPointerData(Module* module, uint32_t heap_base) {
+  // align to 8 bytes
+  uint32_t heap_ptr = (heap_base + 7) & ~7;
+  auto field = MakeUnique<DataSegmentModuleField>();
+  DataSegment& segment = field->data_segment;
+  segment.memory_var = Var(0);
+  segment.offset.push_back(MakeUnique<ConstExpr>(Const::I32(0)));
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&heap_ptr);
+  segment.data.assign(bytes, bytes + sizeof(heap_ptr));
+  module->AppendField(std::move(field));
+}
+
+// Offset of a segment placed by an i32.const expression.
+bool GetConstOffset(const DataSegment& segment, uint32_t* offset) {
+  if (segment.offset.size() != 1 ||
+      segment.offset.front().type() != ExprType::Const) {
+    return false;
+  }
+  const Const& value = cast<ConstExpr>(&segment.offset.front())->const_;
+  if (value.type != Type::I32) {
+    return false;
+  }
+  *offset = value.u32;
+  return true;
+}
+
+void SetConstOffset(DataSegment* segment, uint32_t offset) {
+  cast<ConstExpr>(&segment->offset.front())->const_.u32 = offset;
+}
+
+// Marks the live functions, globals and types starting from the roots of the
+// module, then drops the rest and renumbers the references. The same visitor
+// is used for both passes: every reference goes through the Use* methods,
+// which either mark the referenced item or rewrite the index.
+class DeadCodeEliminator : public ExprVisitor::DelegateNop {
+ public:
+  explicit DeadCodeEliminator(Module* module);
+
+  void Run(DeadCodeStats* removed);
+
+  // Implementation of ExprVisitor::DelegateNop.
+  Result BeginBlockExpr(BlockExpr* expr) override;
+  Result BeginLoopExpr(LoopExpr* expr) override;
+  Result BeginIfExpr(IfExpr* expr) override;
+  Result BeginIfExceptExpr(IfExceptExpr* expr) override;
+  Result BeginTryExpr(TryExpr* expr) override;
+  Result OnCallExpr(CallExpr* expr) override;
+  Result OnCallIndirectExpr(CallIndirectExpr* expr) override;
+  Result OnGetGlobalExpr(GetGlobalExpr* expr) override;
+  Result OnSetGlobalExpr(SetGlobalExpr* expr) override;
+
+ private:
+  void UseFunc(Var* var);
+  void UseGlobal(Var* var);
+  void UseType(FuncDeclaration* decl);
+  void UseExprs(ExprList* exprs);
+  void VisitRoots();
+
+  template <typename T>
+  static Index Compact(std::vector<T*>* items,
+                       const std::vector<bool>& live,
+                       std::vector<Index>* new_index);
+
+  Module* module_;
+  ExprVisitor visitor_;
+  bool renumber_ = false;
+  std::vector<bool> live_funcs_;
+  std::vector<bool> live_globals_;
+  std::vector<bool> live_types_;
+  std::vector<Index> func_index_;
+  std::vector<Index> global_index_;
+  std::vector<Index> type_index_;
+  std::vector<Index> worklist_;
+};
+
+DeadCodeEliminator::DeadCodeEliminator(Module* module)
+    : module_(module),
+      visitor_(this),
+      live_funcs_(module->funcs.size()),
+      live_globals_(module->globals.size()),
+      live_types_(module->func_types.size()) {}
+
+void DeadCodeEliminator::UseFunc(Var* var) {
+  Index index = var->index();
+  if (renumber_) {
+    var->set_index(func_index_[index]);
+  } else if (!live_funcs_[index]) {
+    live_funcs_[index] = true;
+    worklist_.push_back(index);
+  }
+}
+
+void DeadCodeEliminator::UseGlobal(Var* var) {
+  Index index = var->index();
+  if (renumber_) {
+    var->set_index(global_index_[index]);
+  } else if (!live_globals_[index]) {
+    live_globals_[index] = true;
+    UseExprs(&module_->globals[index]->init_expr);
+  }
+}
+
+void DeadCodeEliminator::UseType(FuncDeclaration* decl) {
+  if (decl->has_func_type) {
+    Index index = decl->type_var.index();
+    if (renumber_) {
+      decl->type_var.set_index(type_index_[index]);
+    } else {
+      live_types_[index] = true;
+    }
+  } else if (!renumber_) {
+    // the type is looked up by the signature when it's written
+    Index index = module_->GetFuncTypeIndex(decl->sig);
+    if (index != kInvalidIndex) {
+      live_types_[index] = true;
+    }
+  }
+}
+
+void DeadCodeEliminator::UseExprs(ExprList* exprs) {
+  visitor_.VisitExprList(*exprs);
+}
+
+void DeadCodeEliminator::VisitRoots() {
+  for (Export* export_ : module_->exports) {
+    if (export_->kind == ExternalKind::Func) {
+      UseFunc(&export_->var);
+    } else if (export_->kind == ExternalKind::Global) {
+      UseGlobal(&export_->var);
+    }
+  }
+  for (Var* start : module_->starts) {
+    UseFunc(start);
+  }
+  // everything in the table may be called indirectly
+  for (ElemSegment* segment : module_->elem_segments) {
+    UseExprs(&segment->offset);
+    for (Var& var : segment->vars) {
+      UseFunc(&var);
+    }
+  }
+  for (DataSegment* segment : module_->data_segments) {
+    UseExprs(&segment->offset);
+  }
+}
+
+template <typename T>
+Index DeadCodeEliminator::Compact(std::vector<T*>* items,
+                                  const std::vector<bool>& live,
+                                  std::vector<Index>* new_index) {
+  std::vector<T*> kept;
+  new_index->assign(items->size(), kInvalidIndex);
+  for (size_t i = 0; i < items->size(); ++i) {
+    if (live[i]) {
+      (*new_index)[i] = kept.size();
+      kept.push_back((*items)[i]);
+    }
+  }
+  Index removed = items->size() - kept.size();
+  *items = std::move(kept);
+  return removed;
+}
+
+void DeadCodeEliminator::Run(DeadCodeStats* removed) {
+  VisitRoots();
+  while (!worklist_.empty()) {
+    Func* func = module_->funcs[worklist_.back()];
+    worklist_.pop_back();
+    UseType(&func->decl);
+    visitor_.VisitFunc(func);
+  }
+
+  // the imports are the first items of the index spaces
+  std::vector<Import*> imports;
+  Index func_imports = 0;
+  Index global_imports = 0;
+  Index func = 0;
+  Index global = 0;
+  for (Import* import : module_->imports) {
+    bool live = true;
+    if (import->kind() == ExternalKind::Func) {
+      live = live_funcs_[func++];
+      func_imports += live;
+    } else if (import->kind() == ExternalKind::Global) {
+      live = live_globals_[global++];
+      global_imports += live;
+    }
+    if (live) {
+      imports.push_back(import);
+    }
+  }
+  Index func_imports_removed = func - func_imports;
+  Index global_imports_removed = global - global_imports;
+  removed->imports = module_->imports.size() - imports.size();
+  module_->imports = std::move(imports);
+  module_->num_func_imports = func_imports;
+  module_->num_global_imports = global_imports;
+
+  removed->funcs = Compact(&module_->funcs, live_funcs_, &func_index_) -
+                   func_imports_removed;
+  removed->globals = Compact(&module_->globals, live_globals_, &global_index_) -
+                     global_imports_removed;
+  removed->types = Compact(&module_->func_types, live_types_, &type_index_);
+
+  renumber_ = true;
+  VisitRoots();
+  for (Func* func : module_->funcs) {
+    UseType(&func->decl);
+    visitor_.VisitFunc(func);
+  }
+  for (Global* global : module_->globals) {
+    UseExprs(&global->init_expr);
+  }
+  // the bindings of the names are stale now
+  module_->func_bindings.clear();
+  module_->global_bindings.clear();
+  module_->func_type_bindings.clear();
+}
+
+Result DeadCodeEliminator::BeginBlockExpr(BlockExpr* expr) {
+  UseType(&expr->block.decl);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::BeginLoopExpr(LoopExpr* expr) {
+  UseType(&expr->block.decl);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::BeginIfExpr(IfExpr* expr) {
+  UseType(&expr->true_.decl);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::BeginIfExceptExpr(IfExceptExpr* expr) {
+  UseType(&expr->true_.decl);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::BeginTryExpr(TryExpr* expr) {
+  UseType(&expr->block.decl);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::OnCallExpr(CallExpr* expr) {
+  UseFunc(&expr->var);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::OnCallIndirectExpr(CallIndirectExpr* expr) {
+  UseType(&expr->decl);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::OnGetGlobalExpr(GetGlobalExpr* expr) {
+  UseGlobal(&expr->var);
+  return Result::Ok;
+}
+
+Result DeadCodeEliminator::OnSetGlobalExpr(SetGlobalExpr* expr) {
+  UseGlobal(&expr->var);
+  return Result::Ok;
+}
+
+}  // end anonymous namespace
+
+Result PostProcessModule(Module* module, ErrorHandler* error_handler) {
+  // the stack and the heap pointers of wasm-ld are the first two globals
+  if (module->globals.size() < 2 || module->num_global_imports != 0) {
+    error_handler->OnError(
+        ErrorLevel::Error, kInvalidOffset,
+        "expected the stack and heap pointer globals of wasm-ld");
+    return Result::Error;
+  }
+  uint32_t heap_base;
+  if (!GetConstGlobalInit(*module, 1, &heap_base)) {
+    error_handler->OnError(
+        ErrorLevel::Error, kInvalidOffset,
+        "expected an i32.const initializer of the heap pointer global");
+    return Result::Error;
+  }
+  StripZeroedData(module);
+  AddHeapPointerData(module, heap_base);
+  return Result::Ok;
+}
+
+Result EliminateDeadCode(Module* module, DeadCodeStats* removed) {
+  DeadCodeEliminator eliminator(module);
+  eliminator.Run(removed);
+  return Result::Ok;
+}
+
+Index CoalesceDataSegments(Module* module, uint32_t max_gap) {
+  struct Span {
+    uint32_t begin;
+    DataSegment* segment;
+
+    uint64_t end() const { return uint64_t(begin) + segment->data.size(); }
+  };
+
+  std::vector<Span> spans;
+  for (DataSegment* segment : module->data_segments) {
+    uint32_t offset;
+    if (!GetConstOffset(*segment, &offset)) {
+      return 0;
+    }
+    spans.push_back(Span{offset, segment});
+  }
+  std::stable_sort(spans.begin(), spans.end(),
+                   [](const Span& a, const Span& b) { return a.begin < b.begin; });
+  // the later of the overlapping segments wins, keep it simple and don't
+  // reorder them
+  for (size_t i = 1; i < spans.size(); ++i) {
+    if (spans[i].begin < spans[i - 1].end()) {
+      return 0;
+    }
+  }
+
+  // the memory is zeroed, so the zeros at the ends don't need to be written
+  std::vector<Span> trimmed;
+  for (Span& span : spans) {
+    std::vector<uint8_t>& data = span.segment->data;
+    auto first = std::find_if(data.begin(), data.end(),
+                              [](uint8_t datum) { return datum != 0; });
+    if (first == data.end()) {
+      continue;
+    }
+    auto last = std::find_if(data.rbegin(), data.rend(),
+                             [](uint8_t datum) { return datum != 0; });
+    span.begin += first - data.begin();
+    data.erase(last.base(), data.end());
+    data.erase(data.begin(), first);
+    trimmed.push_back(span);
+  }
+
+  std::vector<DataSegment*> segments;
+  for (const Span& span : trimmed) {
+    if (!segments.empty()) {
+      DataSegment* prev = segments.back();
+      uint32_t prev_begin;
+      GetConstOffset(*prev, &prev_begin);
+      uint64_t gap = span.begin - (uint64_t(prev_begin) + prev->data.size());
+      if (gap <= max_gap) {
+        prev->data.resize(prev->data.size() + gap, 0);
+        prev->data.insert(prev->data.end(), span.segment->data.begin(),
+                          span.segment->data.end());
+        continue;
+      }
+    }
+    SetConstOffset(span.segment, span.begin);
+    segments.push_back(span.segment);
+  }
+
+  Index removed = module->data_segments.size() - segments.size();
+  module->data_segments = std::move(segments);
+  return removed;
+}
+
+Result PostProcessBinary(const char* filename,
+                         const void* data,
+                         size_t size,
+                         const PostPassOptions& options,
+                         ErrorHandler* error_handler,
+                         OutputBuffer* out,
+                         PostPassStats* stats) {
+  PostPassStats local_stats;
+  if (!stats) {
+    stats = &local_stats;
+  }
+  stats->input_size = size;
+
+  Clock::time_point start = Clock::now();
+  Module module;
+  const bool kStopOnFirstError = true;
+  ReadBinaryOptions read_options(options.features, nullptr, options.keep_names,
+                                 kStopOnFirstError, false);
+  Result result = ReadBinaryIr(filename, data, size, &read_options,
+                               error_handler, &module);
+  stats->read_time = MillisecondsSince(start);
+  if (Failed(result)) {
+    return result;
+  }
+
+  start = Clock::now();
+  result = PostProcessModule(&module, error_handler);
+  if (Succeeded(result)) {
+    result = EliminateDeadCode(&module, &stats->removed);
+  }
+  if (Succeeded(result)) {
+    stats->removed_data_segments =
+        CoalesceDataSegments(&module, options.data_segment_gap);
+  }
+  stats->process_time = MillisecondsSince(start);
+  if (Failed(result)) {
+    return result;
+  }
+
+  start = Clock::now();
+  MemoryStream stream;
+  WriteBinaryOptions write_options;
+  write_options.write_debug_names = options.keep_names;
+  result = WriteBinaryModule(&stream, &module, &write_options);
+  if (Succeeded(result)) {
+    *out = std::move(*stream.ReleaseOutputBuffer());
+    stats->output_size = out->size();
+  }
+  stats->write_time = MillisecondsSince(start);
+  return result;
+}
+
+}  // namespace wabt
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WABT_POSTPASS_H_
+#define WABT_POSTPASS_H_
+
+#include "src/common.h"
+#include "src/feature.h"
+
+namespace wabt {
+
+class ErrorHandler;
+struct Module;
+struct OutputBuffer;
+
+// Post processing of the modules linked by wasm-ld: strips the data segments
+// that are only initialized to zeros and adds a data segment with the initial
+// heap pointer at address 0. The second global must be initialized by an
+// i32.const with the base of the heap, otherwise the module is rejected and
+// the reason is reported to the error handler.
+Result PostProcessModule(Module*, ErrorHandler*);
+
+struct DeadCodeStats {
+  Index funcs = 0;
+  Index imports = 0;
+  Index types = 0;
+  Index globals = 0;
+};
+
+// Removes the functions, imports, types and globals which are not reachable
+// from the exports, the start function and the elem segments, and renumbers
+// the remaining ones. The module must use indices, not names.
+Result EliminateDeadCode(Module*, DeadCodeStats* removed);
+
+// Trims the leading and trailing zeros of the data segments and merges the
+// segments separated by at most |max_gap| bytes, so the module has fewer and
+// smaller segments. The module is left as is unless all segments have
+// constant offsets and don't overlap. Returns the number of removed segments.
+Index CoalesceDataSegments(Module*, uint32_t max_gap);
+
+// The gap that costs about as much as the offset and the size of a segment.
+static const uint32_t kDefaultDataSegmentGap = 8;
+
+struct PostPassOptions {
+  Features features;
+  uint32_t data_segment_gap = kDefaultDataSegmentGap;
+  bool keep_names = false;  // keep the name section
+};
+
+struct PostPassStats {
+  // wall time of the stages of PostProcessBinary, in milliseconds
+  double read_time = 0;
+  double process_time = 0;
+  double write_time = 0;
+
+  DeadCodeStats removed;
+  Index removed_data_segments = 0;
+  size_t input_size = 0;
+  size_t output_size = 0;
+};
+
+// Reads the binary module, post processes it, eliminates the dead code,
+// coalesces the data segments and writes the resulting binary to |out|,
+// without going through the file system.
+Result PostProcessBinary(const char* filename,
+                         const void* data,
+                         size_t size,
+                         const PostPassOptions& options,
+                         ErrorHandler*,
+                         OutputBuffer* out,
+                         PostPassStats* stats = nullptr);
+
+}  // namespace wabt
+
+#endif /* WABT_POSTPASS_H_ */
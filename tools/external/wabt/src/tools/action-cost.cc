@@ -0,0 +1,170 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "src/action-cost.h"
+#include "src/binary-reader.h"
+#include "src/binary-reader-ir.h"
+#include "src/error-handler.h"
+#include "src/feature.h"
+#include "src/ir.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+
+static std::string s_infile;
+static std::string s_outfile;
+static Features s_features;
+
+static const char s_description[] =
+R"(  Read a contract in the WebAssembly binary format and report, as JSON, the
+  static cost of the code reachable from each action and notify handler:
+  instruction counts, loop nesting, host function call sites and code size.
+
+  The handlers are found by name, link the contract with -fkeep-names.
+
+examples:
+  $ cyberway-cpp -fkeep-names token.cpp -o token.wasm
+  $ eosio-action-cost token.wasm -o token.cost.json
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-action-cost", s_description);
+
+  parser.AddHelpOption();
+  s_features.AddOptions(&parser);
+  parser.AddOption('o', "output", "FILENAME",
+                   "Output file for the report, by default use stdout",
+                   [](const char* argument) {
+                     s_outfile = argument;
+                     ConvertBackslashToSlash(&s_outfile);
+                   });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) {
+                       s_infile = argument;
+                       ConvertBackslashToSlash(&s_infile);
+                     });
+  parser.Parse(argc, argv);
+}
+
+static std::string Quote(const std::string& s) {
+  std::string result = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      wabt_snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      result += escaped;
+    } else {
+      result += c;
+    }
+  }
+  return result + "\"";
+}
+
+static void WriteReport(Stream* stream, const std::vector<ActionCost>& costs) {
+  stream->Writef("[");
+  for (size_t i = 0; i < costs.size(); ++i) {
+    const ActionCost& cost = costs[i];
+    stream->Writef("%s\n  {\n", i ? "," : "");
+    stream->Writef("    \"kind\": %s,\n", Quote(cost.kind).c_str());
+    stream->Writef("    \"name\": %s,\n", Quote(cost.name).c_str());
+    stream->Writef("    \"function\": %" PRIindex ",\n", cost.func_index);
+    stream->Writef("    \"functions\": %" PRIindex ",\n", cost.functions);
+    stream->Writef("    \"instructions\": %" PRIindex ",\n", cost.instructions);
+    stream->Writef("    \"code_size\": %" PRIzd ",\n", cost.code_size);
+    stream->Writef("    \"loops\": %" PRIindex ",\n", cost.loops);
+    stream->Writef("    \"loop_depth\": %" PRIindex ",\n", cost.loop_depth);
+    stream->Writef("    \"indirect_calls\": %" PRIindex ",\n",
+                   cost.indirect_calls);
+    stream->Writef("    \"recursive\": %s,\n",
+                   cost.recursive ? "true" : "false");
+    stream->Writef("    \"host_calls\": {");
+    size_t j = 0;
+    for (const auto& call : cost.host_calls) {
+      stream->Writef("%s\n      %s: %" PRIindex, j++ ? "," : "",
+                     Quote(call.first).c_str(), call.second);
+    }
+    stream->Writef("%s}\n  }", cost.host_calls.empty() ? "" : "\n    ");
+  }
+  stream->Writef("%s]\n", costs.empty() ? "" : "\n");
+}
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<uint8_t> file_data;
+  Result result = ReadFile(s_infile.c_str(), &file_data);
+  if (Failed(result)) {
+    return 1;
+  }
+
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  Module module;
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = false;
+  ReadBinaryOptions options(s_features, nullptr, kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  result = ReadBinaryIr(s_infile.c_str(), file_data.data(), file_data.size(),
+                        &options, &error_handler, &module);
+  if (Failed(result)) {
+    return 1;
+  }
+
+  std::vector<Offset> body_sizes;
+  result = ReadFunctionBodySizes(file_data.data(), file_data.size(), &options,
+                                 &body_sizes);
+  if (Failed(result)) {
+    return 1;
+  }
+
+  std::vector<ActionCost> costs;
+  ComputeActionCosts(module, body_sizes, &costs);
+  if (costs.empty()) {
+    fprintf(stderr,
+            "%s: no action or notify handlers found, link the contract with "
+            "-fkeep-names\n",
+            s_infile.c_str());
+    return 1;
+  }
+
+  if (s_outfile.empty()) {
+    FileStream stream(stdout);
+    WriteReport(&stream, costs);
+  } else {
+    MemoryStream stream;
+    WriteReport(&stream, costs);
+    result = stream.WriteToFile(s_outfile);
+  }
+  return result != Result::Ok;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
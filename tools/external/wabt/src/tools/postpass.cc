@@ -20,32 +20,22 @@
 #include <cstdlib>
 #include <iostream>
 
-#include "src/apply-names.h"
-#include "src/binary-reader.h"
-#include "src/binary-writer.h"
-#include "src/binary-reader-ir.h"
 #include "src/error-handler.h"
 #include "src/feature.h"
-#include "src/generate-names.h"
-#include "src/ir.h"
-#include "src/leb128.h"
 #include "src/option-parser.h"
+#include "src/postpass.h"
 #include "src/stream.h"
-#include "src/validator.h"
-#include "src/wast-lexer.h"
-#include "src/wat-writer.h"
 
 using namespace wabt;
 
 static int s_verbose;
 static std::string s_infile;
 static std::string s_outfile;
-static Features s_features;
-static WriteBinaryOptions s_write_binary_options;
+static PostPassOptions s_options;
 static std::unique_ptr<FileStream> s_log_stream;
 
 static const char s_description[] =
-R"(  Read a file in the WebAssembly binary format, strip bss or any data segment that is only initialized to zeros, and other post processing.
+R"(  Read a file in the WebAssembly binary format, strip bss or any data segment that is only initialized to zeros, remove the functions, imports, types and globals unreachable from the exports and the table, merge the data segments, and other post processing.
 
   $ eosio-pp test.wasm -o test.stripped.wasm
 
@@ -61,6 +51,13 @@ static void ParseOptions(int argc, char** argv) {
     s_log_stream = FileStream::CreateStdout();
   });
   parser.AddHelpOption();
+  parser.AddOption('g', "data-segment-gap", "SIZE",
+                   "Merge the data segments separated by at most SIZE bytes",
+                   [](const std::string& argument) {
+                     s_options.data_segment_gap = atoi(argument.c_str());
+                   });
+  parser.AddOption('n', "keep-names", "Keep the name section",
+                   []() { s_options.keep_names = true; });
   parser.AddOption(
       'o', "output", "FILENAME",
       "Output file for the generated wast file, by default use stdout",
@@ -76,98 +73,41 @@ static void ParseOptions(int argc, char** argv) {
   parser.Parse(argc, argv);
 }
 
-uint32_t GetHeapPtr( Module& mod, const std::vector<uint8_t>& buff ) {
-   size_t offset = mod.GetGlobal(Var(1))->init_expr.begin()->loc.offset;
-   uint32_t heap_ptr;
-   ReadS32Leb128(buff.data()+offset+4, buff.data()+offset+9, &heap_ptr);
-   return heap_ptr;
-}
-
-uint32_t GetStackPtr( Module& mod, const std::vector<uint8_t>& buff ) {
-   size_t offset = mod.GetGlobal(Var(0))->init_expr.begin()->loc.offset;
-   uint32_t stack_ptr;
-   ReadS32Leb128(buff.data()+offset+4, buff.data()+offset+9, &stack_ptr);
-   return stack_ptr;
-}
-
-void StripZeroedData( Module& mod, size_t& fix_bytes ) {
-   std::vector<DataSegment*> ds;
-   for ( auto DS : mod.data_segments ) {
-      bool isZeroed = true;
-      for ( auto datum : DS->data ) {
-         isZeroed &= datum == 0;
-      }
-      if (!isZeroed) {
-         ds.push_back(DS);
-      } else {
-         fix_bytes += DS->data.size();
-      }
-   }
-   mod.data_segments = ds;
-}
-
-void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>& buff, DataSegment& ds ) {
-   uint32_t heap_ptr  = ((GetHeapPtr(mod, buff)) + 7) & ~7; // align to 8 bytes
-   Const c;
-   c.I32(0);
-   std::unique_ptr<Expr> ce(new ConstExpr(c));
-   ds.memory_var = Var(0);
-   ds.offset = ExprList{std::move(ce)};
-   uint8_t* dat = reinterpret_cast<uint8_t*>(&heap_ptr);
-   ds.data = std::vector<uint8_t>{dat[0],
-                                   dat[1], 
-                                   dat[2], 
-                                   dat[3]};
-   mod.data_segments.push_back(&ds);
-}
-
-void construct_apply( Module& mod ) {
-}
-
-void WriteBufferToFile(string_view filename,
-                       const OutputBuffer& buffer) {
-  buffer.WriteToFile(filename);
-}
-
 int ProgramMain(int argc, char** argv) {
   Result result;
-  
+
   InitStdio();
   ParseOptions(argc, argv);
-  
+
   std::vector<uint8_t> file_data;
-  bool stub = false;
-  std::unique_ptr<FileStream> s_log_stream_s;
   result = ReadFile(s_infile.c_str(), &file_data);
-  DataSegment _hds;
   if (Succeeded(result)) {
     ErrorHandlerFile error_handler(Location::Type::Binary);
-    Module module;
-    const bool kStopOnFirstError = true;
-    ReadBinaryOptions options(s_features, s_log_stream_s.get(),
-                              stub, kStopOnFirstError,
-                              stub);
-    result = ReadBinaryIr(s_infile.c_str(), file_data.data(),
-                          file_data.size(), &options, &error_handler, &module);
+    OutputBuffer buffer;
+    PostPassStats stats;
+    result = PostProcessBinary(s_infile.c_str(), file_data.data(),
+                               file_data.size(), s_options, &error_handler,
+                               &buffer, &stats);
 
     if (Succeeded(result)) {
-      size_t fixup = 0;
-      StripZeroedData(module, fixup);
-      AddHeapPointerData(module, fixup, file_data, _hds);
-     if (Succeeded(result)) {
-      MemoryStream stream(s_log_stream.get());
-      result =
-          WriteBinaryModule(&stream, &module, &s_write_binary_options);
-
-      if (Succeeded(result)) {
-        if (s_outfile.empty()) {
-          s_outfile = s_infile;
-        }
-        WriteBufferToFile(s_outfile.c_str(), stream.output_buffer());
+      if (s_outfile.empty()) {
+        s_outfile = s_infile;
       }
+      result = buffer.WriteToFile(s_outfile.c_str());
+    }
+    if (s_log_stream) {
+      s_log_stream->Writef(
+          "read: %.1f ms, post process: %.1f ms, write: %.1f ms\n",
+          stats.read_time, stats.process_time, stats.write_time);
+      s_log_stream->Writef(
+          "removed %" PRIindex " functions, %" PRIindex " imports, %" PRIindex
+          " types, %" PRIindex " globals, %" PRIindex
+          " data segments: %" PRIzd " bytes saved\n",
+          stats.removed.funcs, stats.removed.imports, stats.removed.types,
+          stats.removed.globals, stats.removed_data_segments,
+          static_cast<ptrdiff_t>(stats.input_size) -
+              static_cast<ptrdiff_t>(stats.output_size));
     }
-   } 
-
   }
   return result != Result::Ok;
 }
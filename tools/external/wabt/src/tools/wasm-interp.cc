@@ -19,6 +19,8 @@
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,8 +48,18 @@ static Thread::Options s_thread_options;
 static Stream* s_trace_stream;
 static bool s_run_all_exports;
 static bool s_host_print;
+static bool s_host_stubs;
+static const char* s_profile_file;
+static std::map<std::string, uint64_t> s_stubs;
+static bool s_apply;
+static uint64_t s_apply_args[3];  // receiver, code, action
+static std::vector<char> s_action_data;
 static Features s_features;
 
+// The module run by the eosio host stubs, they access its memory.
+static Environment* s_env;
+static DefinedModule* s_module;
+
 static std::unique_ptr<FileStream> s_log_stream;
 static std::unique_ptr<FileStream> s_stdout_stream;
 
@@ -73,8 +85,96 @@ examples:
   # parse test.wasm and run all its exported functions, setting the
   # value stack size to 100 elements
   $ wasm-interp test.wasm -V 100 --run-all-exports
+
+  # run the transfer action of the contract test.wasm with the stubbed eosio
+  # imports, write the folded stacks to test.folded for flamegraph.pl and
+  # print the instructions and the host calls per function
+  $ wasm-interp test.wasm --host-stubs --apply test:test:transfer \
+      --action-data 0000000000ea3055 --stub current_time=1000 \
+      --profile test.folded
 )";
 
+// The eosio name encoding, 12 characters of [.1-5a-z] and a 13th of [.1-5a-j].
+static uint64_t CharToSymbol(char c) {
+  if (c >= 'a' && c <= 'z') {
+    return (c - 'a') + 6;
+  }
+  if (c >= '1' && c <= '5') {
+    return (c - '1') + 1;
+  }
+  return 0;
+}
+
+static uint64_t StringToName(const std::string& str) {
+  uint64_t name = 0;
+  size_t i = 0;
+  for (; i < str.size() && i < 12; ++i) {
+    name |= (CharToSymbol(str[i]) & 0x1f) << (64 - 5 * (i + 1));
+  }
+  if (i == 12 && str.size() > 12) {
+    name |= CharToSymbol(str[12]) & 0x0f;
+  }
+  return name;
+}
+
+static std::string NameToString(uint64_t name) {
+  static const char kCharmap[] = ".12345abcdefghijklmnopqrstuvwxyz";
+  std::string str(13, '.');
+  for (int i = 0; i <= 12; ++i) {
+    str[12 - i] = kCharmap[name & (i == 0 ? 0x0f : 0x1f)];
+    name >>= (i == 0 ? 4 : 5);
+  }
+  str.erase(str.find_last_not_of('.') + 1);
+  return str;
+}
+
+static void ParseApply(const std::string& argument) {
+  size_t first = argument.find(':');
+  size_t second = argument.find(':', first + 1);
+  if (first == std::string::npos || second == std::string::npos) {
+    WABT_FATAL("invalid --apply \"%s\", expected RECEIVER:CODE:ACTION\n",
+               argument.c_str());
+  }
+  s_apply = true;
+  s_apply_args[0] = StringToName(argument.substr(0, first));
+  s_apply_args[1] = StringToName(argument.substr(first + 1, second - first - 1));
+  s_apply_args[2] = StringToName(argument.substr(second + 1));
+}
+
+static void ParseActionData(const std::string& argument) {
+  if (argument.size() % 2 != 0) {
+    WABT_FATAL("invalid --action-data, odd number of hex digits\n");
+  }
+  s_action_data.clear();
+  for (size_t i = 0; i < argument.size(); i += 2) {
+    char* end;
+    std::string byte = argument.substr(i, 2);
+    unsigned long value = strtoul(byte.c_str(), &end, 16);
+    if (*end != '\0') {
+      WABT_FATAL("invalid --action-data, \"%s\" is not a hex byte\n",
+                 byte.c_str());
+    }
+    s_action_data.push_back(static_cast<char>(value));
+  }
+}
+
+static void ParseStub(const std::string& argument) {
+  size_t equal = argument.find('=');
+  if (equal == std::string::npos || equal == 0) {
+    WABT_FATAL("invalid --stub \"%s\", expected NAME=VALUE\n",
+               argument.c_str());
+  }
+  const char* value = argument.c_str() + equal + 1;
+  char* end;
+  uint64_t result = value[0] == '-' ? strtoll(value, &end, 0)
+                                    : strtoull(value, &end, 0);
+  if (*value == '\0' || *end != '\0') {
+    WABT_FATAL("invalid --stub \"%s\", the value is not an integer\n",
+               argument.c_str());
+  }
+  s_stubs[argument.substr(0, equal)] = result;
+}
+
 static void ParseOptions(int argc, char** argv) {
   OptionParser parser("wasm-interp", s_description);
 
@@ -106,6 +206,25 @@ static void ParseOptions(int argc, char** argv) {
                    "Include an importable function named \"host.print\" for "
                    "printing to stdout",
                    []() { s_host_print = true; });
+  parser.AddOption("host-stubs",
+                   "Stub the imports of the module \"env\" of the eosio "
+                   "contracts, see --stub",
+                   []() { s_host_stubs = true; });
+  parser.AddOption('s', "stub", "NAME=VALUE",
+                   "Return VALUE from the stubbed import NAME instead of the "
+                   "local handler, or of zero. Use multiple times",
+                   [](const char* argument) { ParseStub(argument); });
+  parser.AddOption('a', "apply", "RECEIVER:CODE:ACTION",
+                   "Run the exported function \"apply\" with the eosio names",
+                   [](const char* argument) { ParseApply(argument); });
+  parser.AddOption('d', "action-data", "HEX",
+                   "The action data of the stubbed read_action_data",
+                   [](const char* argument) { ParseActionData(argument); });
+  parser.AddOption('p', "profile", "FILENAME",
+                   "Count the executed instructions and the host calls per "
+                   "function, write the folded stacks to FILENAME and a "
+                   "summary to stdout",
+                   [](const char* argument) { s_profile_file = argument; });
 
   parser.AddArgument("filename", OptionParser::ArgumentCount::One,
                      [](const char* argument) { s_infile = argument; });
@@ -221,11 +340,298 @@ class WasmInterpHostImportDelegate : public HostImportDelegate {
   }
 };
 
+// The local handlers of the eosio imports. The other imports return the value
+// of --stub, or zero.
+class EosioHostImportDelegate : public HostImportDelegate {
+ public:
+  wabt::Result ImportFunc(interp::FuncImport* import,
+                          interp::Func* func,
+                          interp::FuncSignature* func_sig,
+                          const ErrorCallback& callback) override {
+    static const std::map<std::string, HostFuncCallback> kHandlers = {
+        {"action_data_size", ActionDataSizeCallback},
+        {"read_action_data", ReadActionDataCallback},
+        {"current_receiver", CurrentReceiverCallback},
+        {"eosio_assert", AssertCallback},
+        {"eosio_assert_message", AssertMessageCallback},
+        {"eosio_exit", ExitCallback},
+        {"prints", PrintsCallback},
+        {"prints_l", PrintsLCallback},
+        {"printi", PrintiCallback},
+        {"printui", PrintuiCallback},
+        {"printn", PrintnCallback},
+    };
+
+    HostFunc* host_func = cast<HostFunc>(func);
+    auto handler = kHandlers.find(host_func->field_name);
+    if (handler != kHandlers.end() && !s_stubs.count(host_func->field_name)) {
+      host_func->callback = handler->second;
+    } else {
+      host_func->callback = StubCallback;
+    }
+    return wabt::Result::Ok;
+  }
+
+  wabt::Result ImportTable(interp::TableImport* import,
+                           interp::Table* table,
+                           const ErrorCallback& callback) override {
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportMemory(interp::MemoryImport* import,
+                            interp::Memory* memory,
+                            const ErrorCallback& callback) override {
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportGlobal(interp::GlobalImport* import,
+                            interp::Global* global,
+                            const ErrorCallback& callback) override {
+    return wabt::Result::Error;
+  }
+
+ private:
+  static char* GetMemory(uint32_t ptr, uint32_t size) {
+    if (!s_module || s_module->memory_index == kInvalidIndex) {
+      return nullptr;
+    }
+    interp::Memory* memory = s_env->GetMemory(s_module->memory_index);
+    if (uint64_t(ptr) + size > memory->data.size()) {
+      return nullptr;
+    }
+    return memory->data.data() + ptr;
+  }
+
+  static bool GetString(uint32_t ptr, std::string* out_str) {
+    char* start = GetMemory(ptr, 0);
+    if (!start) {
+      return false;
+    }
+    interp::Memory* memory = s_env->GetMemory(s_module->memory_index);
+    char* end = static_cast<char*>(memchr(
+        start, '\0', memory->data.data() + memory->data.size() - start));
+    if (!end) {
+      return false;
+    }
+    out_str->assign(start, end);
+    return true;
+  }
+
+  static void SetResults(const interp::FuncSignature* sig,
+                         Index num_results,
+                         TypedValue* out_results,
+                         uint64_t value) {
+    memset(static_cast<void*>(out_results), 0,
+           sizeof(TypedValue) * num_results);
+    for (Index i = 0; i < num_results; ++i) {
+      out_results[i].type = sig->result_types[i];
+      if (sig->result_types[i] == Type::I32) {
+        out_results[i].value.i32 = static_cast<uint32_t>(value);
+      } else if (sig->result_types[i] == Type::I64) {
+        out_results[i].value.i64 = value;
+      }
+    }
+  }
+
+  static interp::Result StubCallback(const HostFunc* func,
+                                     const interp::FuncSignature* sig,
+                                     Index num_args,
+                                     TypedValue* args,
+                                     Index num_results,
+                                     TypedValue* out_results,
+                                     void* user_data) {
+    auto stub = s_stubs.find(func->field_name);
+    SetResults(sig, num_results, out_results,
+               stub != s_stubs.end() ? stub->second : 0);
+    return interp::Result::Ok;
+  }
+
+  static interp::Result ActionDataSizeCallback(const HostFunc* func,
+                                               const interp::FuncSignature* sig,
+                                               Index num_args,
+                                               TypedValue* args,
+                                               Index num_results,
+                                               TypedValue* out_results,
+                                               void* user_data) {
+    SetResults(sig, num_results, out_results, s_action_data.size());
+    return interp::Result::Ok;
+  }
+
+  static interp::Result ReadActionDataCallback(const HostFunc* func,
+                                               const interp::FuncSignature* sig,
+                                               Index num_args,
+                                               TypedValue* args,
+                                               Index num_results,
+                                               TypedValue* out_results,
+                                               void* user_data) {
+    uint32_t size = args[1].value.i32;
+    if (size == 0) {
+      SetResults(sig, num_results, out_results, s_action_data.size());
+      return interp::Result::Ok;
+    }
+    size = std::min<uint32_t>(size, s_action_data.size());
+    char* data = GetMemory(args[0].value.i32, size);
+    if (!data) {
+      return interp::Result::TrapHostTrapped;
+    }
+    std::copy(s_action_data.begin(), s_action_data.begin() + size, data);
+    SetResults(sig, num_results, out_results, size);
+    return interp::Result::Ok;
+  }
+
+  static interp::Result CurrentReceiverCallback(
+      const HostFunc* func,
+      const interp::FuncSignature* sig,
+      Index num_args,
+      TypedValue* args,
+      Index num_results,
+      TypedValue* out_results,
+      void* user_data) {
+    SetResults(sig, num_results, out_results, s_apply_args[0]);
+    return interp::Result::Ok;
+  }
+
+  static interp::Result AssertCallback(const HostFunc* func,
+                                       const interp::FuncSignature* sig,
+                                       Index num_args,
+                                       TypedValue* args,
+                                       Index num_results,
+                                       TypedValue* out_results,
+                                       void* user_data) {
+    if (args[0].value.i32) {
+      return interp::Result::Ok;
+    }
+    std::string message;
+    GetString(args[1].value.i32, &message);
+    printf("eosio_assert failed: %s\n", message.c_str());
+    return interp::Result::TrapHostTrapped;
+  }
+
+  static interp::Result AssertMessageCallback(const HostFunc* func,
+                                              const interp::FuncSignature* sig,
+                                              Index num_args,
+                                              TypedValue* args,
+                                              Index num_results,
+                                              TypedValue* out_results,
+                                              void* user_data) {
+    if (args[0].value.i32) {
+      return interp::Result::Ok;
+    }
+    uint32_t size = args[2].value.i32;
+    char* message = GetMemory(args[1].value.i32, size);
+    printf("eosio_assert failed: %.*s\n", message ? static_cast<int>(size) : 0,
+           message ? message : "");
+    return interp::Result::TrapHostTrapped;
+  }
+
+  // Stops the execution with a host trap, after the code is printed.
+  static interp::Result ExitCallback(const HostFunc* func,
+                                     const interp::FuncSignature* sig,
+                                     Index num_args,
+                                     TypedValue* args,
+                                     Index num_results,
+                                     TypedValue* out_results,
+                                     void* user_data) {
+    printf("eosio_exit(%d)\n", static_cast<int>(args[0].value.i32));
+    return interp::Result::TrapHostTrapped;
+  }
+
+  static interp::Result PrintsCallback(const HostFunc* func,
+                                       const interp::FuncSignature* sig,
+                                       Index num_args,
+                                       TypedValue* args,
+                                       Index num_results,
+                                       TypedValue* out_results,
+                                       void* user_data) {
+    std::string str;
+    if (!GetString(args[0].value.i32, &str)) {
+      return interp::Result::TrapHostTrapped;
+    }
+    printf("%s", str.c_str());
+    return interp::Result::Ok;
+  }
+
+  static interp::Result PrintsLCallback(const HostFunc* func,
+                                        const interp::FuncSignature* sig,
+                                        Index num_args,
+                                        TypedValue* args,
+                                        Index num_results,
+                                        TypedValue* out_results,
+                                        void* user_data) {
+    uint32_t size = args[1].value.i32;
+    char* str = GetMemory(args[0].value.i32, size);
+    if (!str) {
+      return interp::Result::TrapHostTrapped;
+    }
+    fwrite(str, 1, size, stdout);
+    return interp::Result::Ok;
+  }
+
+  static interp::Result PrintiCallback(const HostFunc* func,
+                                       const interp::FuncSignature* sig,
+                                       Index num_args,
+                                       TypedValue* args,
+                                       Index num_results,
+                                       TypedValue* out_results,
+                                       void* user_data) {
+    printf("%" PRId64, static_cast<int64_t>(args[0].value.i64));
+    return interp::Result::Ok;
+  }
+
+  static interp::Result PrintuiCallback(const HostFunc* func,
+                                        const interp::FuncSignature* sig,
+                                        Index num_args,
+                                        TypedValue* args,
+                                        Index num_results,
+                                        TypedValue* out_results,
+                                        void* user_data) {
+    printf("%" PRIu64, args[0].value.i64);
+    return interp::Result::Ok;
+  }
+
+  static interp::Result PrintnCallback(const HostFunc* func,
+                                       const interp::FuncSignature* sig,
+                                       Index num_args,
+                                       TypedValue* args,
+                                       Index num_results,
+                                       TypedValue* out_results,
+                                       void* user_data) {
+    printf("%s", NameToString(args[0].value.i64).c_str());
+    return interp::Result::Ok;
+  }
+};
+
 static void InitEnvironment(Environment* env) {
   if (s_host_print) {
     HostModule* host_module = env->AppendHostModule("host");
     host_module->import_delegate.reset(new WasmInterpHostImportDelegate());
   }
+  if (s_host_stubs) {
+    HostModule* host_module = env->AppendHostModule("env");
+    host_module->import_delegate.reset(new EosioHostImportDelegate());
+  }
+}
+
+static void RunApply(interp::Module* module, Executor* executor) {
+  TypedValues args;
+  for (uint64_t name : s_apply_args) {
+    args.emplace_back(Type::I64);
+    args.back().value.i64 = name;
+  }
+  ExecResult exec_result = executor->RunExportByName(module, "apply", args);
+  WriteCall(s_stdout_stream.get(), string_view(), "apply", args,
+            exec_result.values, exec_result.result);
+}
+
+static wabt::Result WriteProfile(const Profiler& profiler) {
+  FileStream stream(s_profile_file);
+  if (!stream.is_open()) {
+    fprintf(stderr, "unable to open %s for writing\n", s_profile_file);
+    return wabt::Result::Error;
+  }
+  profiler.WriteFoldedStacks(&stream);
+  profiler.WriteSummary(s_stdout_stream.get());
+  return wabt::Result::Ok;
 }
 
 static wabt::Result ReadAndRunModule(const char* module_filename) {
@@ -237,16 +643,31 @@ static wabt::Result ReadAndRunModule(const char* module_filename) {
   DefinedModule* module = nullptr;
   result = ReadModule(module_filename, &env, &error_handler, &module);
   if (Succeeded(result)) {
+    s_env = &env;
+    s_module = module;
     Executor executor(&env, s_trace_stream, s_thread_options);
+    // The profiler indexes the functions, it's created after the module is
+    // read.
+    std::unique_ptr<Profiler> profiler;
+    if (s_profile_file) {
+      profiler.reset(new Profiler(&env));
+      executor.set_profiler(profiler.get());
+    }
     ExecResult exec_result = executor.RunStartFunction(module);
     if (exec_result.result == interp::Result::Ok) {
       if (s_run_all_exports) {
         RunAllExports(module, &executor, RunVerbosity::Verbose);
       }
+      if (s_apply) {
+        RunApply(module, &executor);
+      }
     } else {
       WriteResult(s_stdout_stream.get(), "error running start function",
                   exec_result.result);
     }
+    if (profiler) {
+      result = WriteProfile(*profiler);
+    }
   }
   return result;
 }
@@ -0,0 +1,223 @@
+#!/usr/bin/env python
+#
+# Copyright 2016 WebAssembly Community Group participants
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Runs the tests of the eosio tools built from wabt. The tests use the format
+# of run-tests.py: the TOOL and ARGS<N> directives and the expected output in
+# a STDOUT block, but only need the eosio executables in --bindir.
+#
+# A test which expects one of its commands to fail gives the exit code in the
+# ERROR directive and the expected error in a STDERR block, the commands after
+# the failed one aren't run.
+#
+# run-eosio-pp: the wat of the test is assembled, post processed by eosio-pp
+# and disassembled by eosio-wasm2wast, which validates the output.
+# run-action-cost: the wat of the test is assembled with the names of the
+# functions and the report of eosio-action-cost is compared.
+# run-eosio-interp: the wat of the test is assembled with the names of the
+# functions and run by wasm-interp, usually with the eosio host stubs.
+# run-eosio-interp-profile: the same with --profile, the folded stacks of the
+# profile are printed after the output of wasm-interp.
+
+from __future__ import print_function
+import argparse
+import difflib
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+TEST_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_TESTS = ['postpass', 'action-cost', 'eosio-interp']
+
+# every command gets the arguments of the ARGS<N> directive with its index
+TOOLS = {
+    'run-eosio-pp': [
+        ['%(eosio-wast2wasm)s', '%(in_file)s', '-o', '%(temp_file)s.wasm'],
+        ['%(eosio-pp)s', '%(temp_file)s.wasm', '-o', '%(temp_file)s.pp.wasm'],
+        ['%(eosio-wasm2wast)s', '%(temp_file)s.pp.wasm'],
+    ],
+    'run-action-cost': [
+        ['%(eosio-wast2wasm)s', '--debug-names', '%(in_file)s', '-o',
+         '%(temp_file)s.wasm'],
+        ['%(eosio-action-cost)s', '%(temp_file)s.wasm'],
+    ],
+    'run-eosio-interp': [
+        ['%(eosio-wast2wasm)s', '--debug-names', '%(in_file)s', '-o',
+         '%(temp_file)s.wasm'],
+        ['%(wasm-interp)s', '%(temp_file)s.wasm'],
+    ],
+    'run-eosio-interp-profile': [
+        ['%(eosio-wast2wasm)s', '--debug-names', '%(in_file)s', '-o',
+         '%(temp_file)s.wasm'],
+        ['%(wasm-interp)s', '%(temp_file)s.wasm', '--profile',
+         '%(temp_file)s.folded'],
+        [sys.executable, '-c',
+         'import sys; sys.stdout.write(open(sys.argv[1]).read())',
+         '%(temp_file)s.folded'],
+    ],
+}
+EXECUTABLES = ['eosio-wast2wasm', 'eosio-wasm2wast', 'eosio-pp',
+               'eosio-action-cost', 'wasm-interp']
+
+
+class TestInfo(object):
+
+  def __init__(self, filename):
+    self.filename = filename
+    self.tool = None
+    self.args = {}
+    self.expected_error = 0
+    self.expected_stdout = ''
+    self.expected_stderr = ''
+    self.source = ''
+    self.Parse()
+
+  def Parse(self):
+    with open(self.filename) as f:
+      lines = f.read().splitlines(True)
+    blocks = {'STDOUT': [], 'STDERR': []}
+    block = None
+    source = []
+    for line in lines:
+      if block:
+        if line.strip() == ';;; %s ;;)' % block:
+          block = None
+        else:
+          blocks[block].append(line)
+        continue
+      m = re.match(r'\s*\(;; (STDOUT|STDERR) ;;;$', line)
+      if m:
+        block = m.group(1)
+        continue
+      m = re.match(r';;;\s*([A-Z0-9-]+):\s*(.*)$', line)
+      if m:
+        key, value = m.group(1), m.group(2)
+        if key == 'TOOL':
+          self.tool = value.strip()
+        elif key == 'ERROR':
+          self.expected_error = int(value)
+        elif key.startswith('ARGS'):
+          self.args[int(key[len('ARGS'):] or 0)] = shlex.split(value)
+        continue
+      source.append(line)
+    if self.tool not in TOOLS:
+      raise Exception('%s: unknown tool %r' % (self.filename, self.tool))
+    self.expected_stdout = ''.join(blocks['STDOUT'])
+    self.expected_stderr = ''.join(blocks['STDERR'])
+    self.source = ''.join(source)
+
+  # Returns the stdout of the commands and the stderr of the failed one.
+  def Run(self, variables):
+    stdout = ''
+    for index, command in enumerate(TOOLS[self.tool]):
+      cmd = [arg % variables for arg in command] + self.args.get(index, [])
+      process = subprocess.Popen(cmd, stdout=subprocess.PIPE,
+                                 stderr=subprocess.PIPE,
+                                 universal_newlines=True)
+      out, err = process.communicate()
+      stdout += out
+      if process.returncode == 0:
+        continue
+      if process.returncode != self.expected_error:
+        raise Exception('%s failed with %d:\n%s' %
+                        (' '.join(cmd), process.returncode, err))
+      return stdout, err
+    if self.expected_error:
+      raise Exception('expected an error %d' % self.expected_error)
+    return stdout, ''
+
+  def Rebase(self, stdout, stderr):
+    with open(self.filename, 'w') as f:
+      for index in sorted(self.args):
+        f.write(';;; ARGS%d: %s\n' % (index, ' '.join(self.args[index])))
+      if self.expected_error:
+        f.write(';;; ERROR: %d\n' % self.expected_error)
+      f.write(';;; TOOL: %s\n' % self.tool)
+      f.write(self.source.lstrip('\n'))
+      if stderr:
+        f.write('(;; STDERR ;;;\n%s;;; STDERR ;;)\n' % stderr)
+      f.write('(;; STDOUT ;;;\n%s;;; STDOUT ;;)\n' % stdout)
+
+
+def FindTests(patterns):
+  tests = []
+  for pattern in patterns or DEFAULT_TESTS:
+    path = os.path.join(TEST_DIR, pattern)
+    if os.path.isdir(path):
+      for root, _, files in os.walk(path):
+        tests.extend(os.path.join(root, f) for f in files
+                     if f.endswith('.txt'))
+    else:
+      tests.append(path)
+  return sorted(tests)
+
+
+def main(args):
+  parser = argparse.ArgumentParser()
+  parser.add_argument('--bindir', metavar='PATH', required=True,
+                      help='directory of the eosio executables.')
+  parser.add_argument('-r', '--rebase', action='store_true',
+                      help='rebase the expected output of the tests.')
+  parser.add_argument('patterns', metavar='pattern', nargs='*',
+                      help='test files or directories, relative to test/.')
+  options = parser.parse_args(args)
+
+  variables = {}
+  for exe in EXECUTABLES:
+    variables[exe] = os.path.join(options.bindir, exe)
+
+  temp_dir = tempfile.mkdtemp()
+  failed = []
+  try:
+    tests = FindTests(options.patterns)
+    for index, test in enumerate(tests):
+      name = os.path.relpath(test, TEST_DIR)
+      info = TestInfo(test)
+      variables['in_file'] = test
+      variables['temp_file'] = os.path.join(temp_dir, str(index))
+      try:
+        stdout, stderr = info.Run(variables)
+      except Exception as e:
+        failed.append(name)
+        print('FAIL: %s\n%s' % (name, e))
+        continue
+      if options.rebase:
+        info.Rebase(stdout, stderr)
+      elif (stdout, stderr) != (info.expected_stdout, info.expected_stderr):
+        failed.append(name)
+        print('FAIL: %s' % name)
+        for expected, actual in ((info.expected_stdout, stdout),
+                                 (info.expected_stderr, stderr)):
+          sys.stdout.writelines(difflib.unified_diff(
+              expected.splitlines(True), actual.splitlines(True),
+              'expected', 'actual'))
+      else:
+        print('PASS: %s' % name)
+  finally:
+    shutil.rmtree(temp_dir)
+
+  if failed:
+    print('**** FAILED: %s' % ', '.join(failed))
+    return 1
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))
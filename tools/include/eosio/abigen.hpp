@@ -413,6 +413,16 @@ namespace eosio { namespace cdt {
           return o;
        }
       
+      // forgets the abi of the previous input
+      void reset() {
+         _abi = abi{};
+         indexes.clear();
+         tables.clear();
+         ctables.clear();
+         rcs.clear();
+         evaluated.clear();
+      }
+
       bool is_empty() {
          std::set<abi_table> set_of_tables;
          for ( auto t : ctables ) {
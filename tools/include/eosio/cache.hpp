@@ -0,0 +1,114 @@
+#pragma once
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace eosio { namespace cdt {
+
+   // Content-addressed cache of build products.
+   // An entry is a file <dir>/llvmcache-<key>.<kind>, where the key is the SHA-1 of everything the product depends on.
+   // The directory is pruned with the llvm cache pruning (the one of the ThinLTO cache),
+   // least recently used entries are removed when the total size is above the limit.
+   class compilation_cache {
+      public:
+         class key_builder {
+            public:
+               key_builder& add(llvm::StringRef data) {
+                  // length prefixed, so the parts can't run together
+                  const uint64_t size = data.size();
+                  hasher.update(llvm::StringRef(reinterpret_cast<const char*>(&size), sizeof(size)));
+                  hasher.update(data);
+                  return *this;
+               }
+
+               bool add_file(const std::string& fn) {
+                  auto buf = llvm::MemoryBuffer::getFile(fn);
+                  if (!buf)
+                     return false;
+                  add((*buf)->getBuffer());
+                  return true;
+               }
+
+               std::string final() {
+                  return llvm::toHex(hasher.final(), true);
+               }
+
+            private:
+               llvm::SHA1 hasher;
+         };
+
+         compilation_cache(const std::string& dir, uint64_t max_size)
+            : dir(dir), max_size(max_size) {
+            if (!dir.empty() && llvm::sys::fs::create_directories(dir))
+               this->dir.clear();
+         }
+
+         bool enabled()const { return !dir.empty(); }
+
+         // Copies the entry to `dest`, returns false on a miss.
+         // Secondary products of the same key are fetched with count = false, so they don't change the statistics.
+         bool fetch(const std::string& key, const std::string& kind, const std::string& dest, bool count = true) {
+            if (!enabled())
+               return false;
+            if (!llvm::sys::fs::exists(entry(key, kind)) || llvm::sys::fs::copy_file(entry(key, kind), dest)) {
+               if (count)
+                  ++misses;
+               return false;
+            }
+            if (count)
+               ++hits;
+            return true;
+         }
+
+         // Copies `src` to the entry, the entry appears atomically, so concurrent builds can share the cache
+         void store(const std::string& key, const std::string& kind, const std::string& src) {
+            if (!enabled())
+               return;
+            llvm::SmallString<128> tmp;
+            if (llvm::sys::fs::createUniqueFile(dir + "/tmp-%%%%%%%%", tmp))
+               return;
+            if (llvm::sys::fs::copy_file(src, tmp) || llvm::sys::fs::rename(tmp, entry(key, kind))) {
+               llvm::sys::fs::remove(tmp);
+               return;
+            }
+            stored = true;
+         }
+
+         void prune() {
+            if (!enabled() || !stored)
+               return;
+            llvm::CachePruningPolicy policy;
+            policy.Interval = std::chrono::seconds(0);
+            policy.MaxSizeBytes = max_size;
+            policy.MaxSizePercentageOfAvailableSpace = 0;
+            llvm::pruneCache(dir, policy);
+         }
+
+         void report(llvm::raw_ostream& os)const {
+            os << "cache " << dir << ": " << hits.load() << " hits, " << misses.load() << " misses\n";
+         }
+
+      private:
+         std::string entry(const std::string& key, const std::string& kind)const {
+            return dir + "/llvmcache-" + key + "." + kind;
+         }
+
+         std::string       dir;
+         uint64_t          max_size;
+         std::atomic<int>  hits{0};
+         std::atomic<int>  misses{0};
+         std::atomic<bool> stored{false};
+   };
+
+}} // ns eosio::cdt
@@ -22,6 +22,7 @@
 #include <eosio/whereami/whereami.hpp>
 #include <eosio/abi.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <fstream>
@@ -29,8 +30,10 @@
 #include <memory>
 #include <set>
 #include <map>
+#include <mutex>
 #include <chrono>
 #include <ctime>
+#include <tuple>
 #include <utility>
 
 using namespace clang;
@@ -79,6 +82,8 @@ namespace eosio { namespace cdt {
          std::set<std::string> datastream_uses;
          std::set<std::string> actions;
          std::set<std::string> notify_handlers;
+         std::set<std::string> action_names; //used for validations
+         std::set<std::string> notify_names; //used for validations
          ASTContext *ast_context;
          std::map<std::string, CXXMethodDecl*> cxx_methods;
          std::map<std::string, CXXRecordDecl*> cxx_records;
@@ -87,15 +92,26 @@ namespace eosio { namespace cdt {
          llvm::ArrayRef<std::string>           sources;
          size_t                                source_index = 0;
          std::map<std::string, std::string>    tmp_files;
+         std::string                           output;
+         bool                                  dispatch_table = false;
 
          codegen() : generation_utils([&](){throw codegen_ex;}) {
          }
 
+         // every compilation thread has its own state, so inputs can be processed concurrently
          static codegen& get() {
-            static codegen inst;
+            static thread_local codegen inst;
             return inst;
          }
 
+         // the dispatchers of the previous input of the thread are in its own object, so every input emits its own
+         void reset() {
+            actions.clear();
+            notify_handlers.clear();
+            action_names.clear();
+            notify_names.clear();
+         }
+
          void set_contract_name(std::string cn) {
             contract_name = cn;
          }
@@ -103,12 +119,22 @@ namespace eosio { namespace cdt {
          void set_abi(std::string s) {
             abi = s;
          }
+
+         // the file which receives the rewritten source
+         void set_output(std::string fn) {
+            output = fn;
+         }
+
+         // generate the apply of the contract with a sorted table of its actions and notify handlers
+         void set_dispatch_table(bool b) {
+            dispatch_table = b;
+         }
    };
 
-   std::map<std::string, std::vector<include_double>>  global_includes;
+   thread_local std::map<std::string, std::vector<include_double>>  global_includes;
 
    // remove after v1.7.0
-   bool has_eosiolib = false;
+   thread_local bool has_eosiolib = false;
 
    class eosio_ppcallbacks : public PPCallbacks {
       public:
@@ -150,9 +176,21 @@ namespace eosio { namespace cdt {
          Rewriter  rewriter;
          CompilerInstance* ci;
          bool apply_was_found = false;
+         bool apply_was_created = false;
          std::vector<std::string> action_log;
          std::vector<std::string> notify_log;
 
+         struct dispatch_entry {
+            uint64_t    code;    // 0 for actions and the "*" notify handlers
+            uint64_t    action;
+            std::string func;
+            bool operator<(const dispatch_entry& e) const {
+               return std::tie(code, action) < std::tie(e.code, e.action);
+            }
+         };
+         std::vector<dispatch_entry> action_entries;
+         std::vector<dispatch_entry> notify_entries;
+
       public:
          std::vector<CXXMethodDecl*> action_decls;
          std::vector<CXXMethodDecl*> notify_decls;
@@ -225,7 +263,7 @@ namespace eosio { namespace cdt {
          */
 
          template <typename F>
-         void create_dispatch(const std::string& attr, const std::string& func_name, F&& get_str, CXXMethodDecl* decl, std::vector<std::string>& log) {
+         bool create_dispatch(const std::string& attr, const std::string& func_name, F&& get_str, CXXMethodDecl* decl, std::vector<std::string>& log) {
             constexpr static uint32_t max_stack_size = 512;
             std::stringstream ss;
             codegen& cg = codegen::get();
@@ -237,6 +275,8 @@ namespace eosio { namespace cdt {
                } else {
                   ss << "\n\n#include <eosio/datastream.hpp>\n";
                   ss << "#include <eosio/name.hpp>\n";
+                  ss << "#include <eosio/bytes_view.hpp>\n";
+                  ss << "#include <eosio/action.hpp>\n";
                }
                ss << "extern \"C\" {\n";
                ss << "uint32_t action_data_size();\n";
@@ -246,13 +286,21 @@ namespace eosio { namespace cdt {
                ss << ":";
                ss << func_name << nm;
                ss << "\"))) void " << func_name << nm << "(unsigned long long r, unsigned long long c) {\n";
-               ss << "size_t as = ::action_data_size();\n";
-               ss << "void* buff = nullptr;\n";
-               ss << "if (as > 0) {\n";
-               ss << "buff = as >= " << max_stack_size << " ? malloc(as) : alloca(as);\n";
-               ss << "::read_action_data(buff, as);\n";
-               ss << "}\n";
-               ss << "eosio::datastream<const char*> ds{(char*)buff, as};\n";
+               // the action data is kept after the action returns,
+               // std::string_view and eosio::bytes_view arguments are unpacked as views into it
+               if (has_eosiolib) {
+                  ss << "size_t as = ::action_data_size();\n";
+                  ss << "void* buff = nullptr;\n";
+                  ss << "if (as > 0) {\n";
+                  ss << "buff = as >= " << max_stack_size << " ? malloc(as) : alloca(as);\n";
+                  ss << "::read_action_data(buff, as);\n";
+                  ss << "}\n";
+                  ss << "eosio::datastream<const char*> ds{(char*)buff, as};\n";
+               } else {
+                  // the same arena as execute_action, large data doesn't allocate on every action
+                  ss << "auto data = eosio::get_action_data();\n";
+                  ss << "eosio::datastream<const char*> ds{data.data(), data.size()};\n";
+               }
                int i=0;
                for (auto param : decl->parameters()) {
                   clang::LangOptions lang_opts;
@@ -278,30 +326,81 @@ namespace eosio { namespace cdt {
 
                rewriter.InsertTextAfter(ci->getSourceManager().getLocForEndOfFile(main_fid), ss.str());
                log.push_back(get_str(decl));
+               return true;
             }
+            return false;
          }
 
          void create_action_dispatch(CXXMethodDecl* decl) {
             auto func = [](CXXMethodDecl* d) { return generation_utils::get_action_name(d); };
-            create_dispatch("eosio_wasm_action", "__eosio_action_", func, decl, action_log);
+            if (create_dispatch("eosio_wasm_action", "__eosio_action_", func, decl, action_log))
+               action_entries.push_back({0, string_to_name(func(decl).c_str()), "__eosio_action_"+get_stub_suffix(decl)});
          }
 
          void create_notify_dispatch(CXXMethodDecl* decl) {
             auto func = [](CXXMethodDecl* d) { return generation_utils::get_notify_pair(d); };
-            create_dispatch("eosio_wasm_notify", "__eosio_notify_", func, decl, notify_log);
+            if (create_dispatch("eosio_wasm_notify", "__eosio_notify_", func, decl, notify_log)) {
+               auto pair = func(decl);
+               auto code = pair.substr(0, pair.find("::"));
+               notify_entries.push_back({code == "*" ? 0 : string_to_name(code.c_str()),
+                     string_to_name(pair.substr(pair.find("::")+2).c_str()), "__eosio_notify_"+get_stub_suffix(decl)});
+            }
+         }
+
+         static std::string get_stub_suffix(CXXMethodDecl* decl) {
+            return decl->getNameAsString()+"_"+decl->getParent()->getNameAsString();
+         }
+
+         /**
+          * Generates the apply of the contract, which finds the dispatcher of the action or the notification
+          * by a binary search in the tables sorted by the 64-bit names (see eosio::find_dispatch_entry).
+          * An unknown action fails with eosio_assert_code(false, 1) like the apply generated by the linker,
+          * an unknown notification is ignored.
+          * Only the actions of this source are in the tables, so the contract must be in one source;
+          * nothing is generated if the source has its own apply.
+          */
+         std::string create_apply() {
+            if (!cg.dispatch_table || apply_was_found || has_eosiolib || (action_entries.empty() && notify_entries.empty()))
+               return "";
+
+            auto write_table = [](std::stringstream& ss, const char* name, std::vector<dispatch_entry>& entries) {
+               std::stable_sort(entries.begin(), entries.end());
+               entries.erase(std::unique(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+                  return !(a < b) && !(b < a);
+               }), entries.end());
+               ss << "static const eosio::dispatch_entry " << name << "[] = {\n";
+               for (const auto& e : entries)
+                  ss << "{" << e.code << "ULL, " << e.action << "ULL, &" << e.func << "},\n";
+               ss << "{0, 0, nullptr}};\n";
+            };
+
+            std::stringstream ss;
+            ss << "\n#include <eosio/dispatcher.hpp>\n";
+            ss << "extern \"C\" {\n";
+            ss << "void eosio_assert_code(uint32_t, uint64_t);\n";
+            write_table(ss, "__eosio_action_table", action_entries);
+            write_table(ss, "__eosio_notify_table", notify_entries);
+            ss << "__attribute__((eosio_wasm_entry)) void apply(unsigned long long r, unsigned long long c, unsigned long long a) {\n";
+            ss << "const auto* e = r == c ?\n";
+            ss << "eosio::find_dispatch_entry(__eosio_action_table, " << action_entries.size() << ", 0, a) :\n";
+            ss << "eosio::find_dispatch_entry(__eosio_notify_table, " << notify_entries.size() << ", c, a);\n";
+            ss << "if (!e && r != c) e = eosio::find_dispatch_entry(__eosio_notify_table, " << notify_entries.size() << ", 0, a);\n";
+            ss << "if (e) e->handler(r, c);\n";
+            ss << "else if (r == c) eosio_assert_code(false, 1);\n";
+            ss << "}}\n";
+            apply_was_created = true;
+            return ss.str();
          }
 
          virtual bool VisitCXXMethodDecl(CXXMethodDecl* decl) {
             std::string name = decl->getNameAsString();
-            static std::set<std::string> _action_set; //used for validations
-            static std::set<std::string> _notify_set; //used for validations
             if (decl->isEosioAction()) {
                name = generation_utils::get_action_name(decl);
                validate_name(name, [&]() {emitError(*ci, decl->getLocation(), "action not a valid eosio name");});
-               if (!_action_set.count(name))
-                  _action_set.insert(name);
+               if (!cg.action_names.count(name))
+                  cg.action_names.insert(name);
                else {
-                  auto itr = _action_set.find(name);
+                  auto itr = cg.action_names.find(name);
                   if (*itr != name)
                      emitError(*ci, decl->getLocation(), "action declaration doesn't match previous declaration");
                }
@@ -320,10 +419,10 @@ namespace eosio { namespace cdt {
                auto second = name.substr(name.find("::")+2);
                validate_name(second, [&]() {emitError(*ci, decl->getLocation(), "invalid action name");});
 
-               if (!_notify_set.count(name))
-                  _notify_set.insert(name);
+               if (!cg.notify_names.count(name))
+                  cg.notify_names.insert(name);
                else {
-                  auto itr = _notify_set.find(name);
+                  auto itr = cg.notify_names.find(name);
                   if (*itr != name)
                      emitError(*ci, decl->getLocation(), "notify handler declaration doesn't match previous declaration");
                }
@@ -340,7 +439,7 @@ namespace eosio { namespace cdt {
 
          virtual bool VisitDecl(clang::Decl* decl) {
             if (auto* fd = dyn_cast<clang::FunctionDecl>(decl)) {
-               if (fd->getNameInfo().getAsString() == "apply")
+               if (fd->getNameInfo().getAsString() == "apply" && fd->isExternC())
                   apply_was_found = true;
             }
             return true;
@@ -348,7 +447,7 @@ namespace eosio { namespace cdt {
 
          /*
          virtual bool VisitRecordDecl(RecordDecl* decl) {
-            static std::set<std::string> _action_set; //used for validations
+            static thread_local std::set<std::string> _action_set; //used for validations
             std::string rec_name = decl->getQualifiedNameAsString();
             cg.records.emplace(rec_name, decl);
             return true;
@@ -375,6 +474,8 @@ namespace eosio { namespace cdt {
          */
 
          void print_log() {
+            static std::mutex log_mutex;
+            std::lock_guard<std::mutex> lock(log_mutex);
             if (!action_log.empty()) {
                 llvm::outs() << "Added action dispatchers to " << main_name << ": ";
                 for (auto& s : action_log) {
@@ -389,6 +490,10 @@ namespace eosio { namespace cdt {
                 }
                 llvm::outs() << "\n";
              }
+            if (apply_was_created) {
+                llvm::outs() << "Added dispatch table to " << main_name << ": " << action_entries.size() << " actions, "
+                             << notify_entries.size() << " notify handlers\n";
+             }
          }
       };
 
@@ -418,21 +523,18 @@ namespace eosio { namespace cdt {
                
                for (auto nd : visitor->notify_decls)
                   visitor->create_notify_dispatch(nd);
+               auto apply = visitor->create_apply();
                visitor->print_log();
 
-               int fd;
-               llvm::SmallString<128> fn;
                try {
-                  SmallString<64> res;
-                  llvm::sys::path::system_temp_directory(true, res);
-
-                  std::ofstream out(std::string(res.c_str())+"/"+llvm::sys::path::filename(main_fe->getName()).str());
+                  std::ofstream out(cg.output);
                   for (auto inc : global_includes[main_file]) {
                      visitor->get_rewriter().ReplaceText(inc.range,
                            std::string("\"")+inc.file_name+"\"\n");
                   }
                   // generate apply stub with abi
                   std::stringstream ss;
+                  ss << apply;
                   ss << "extern \"C\" {\n";
                   ss << "void eosio_assert_code(uint32_t, uint64_t);";
                   ss << "\t__attribute__((weak, eosio_wasm_entry, eosio_wasm_abi(";
@@ -446,7 +548,7 @@ namespace eosio { namespace cdt {
                   visitor->get_rewriter().InsertTextAfter(ci->getSourceManager().getLocForEndOfFile(fid), ss.str());
                   auto& RewriteBuf = visitor->get_rewriter().getEditBuffer(fid);
                   out << std::string(RewriteBuf.begin(), RewriteBuf.end());
-                  cg.tmp_files.emplace(main_file, fn.str());
+                  cg.tmp_files.emplace(main_file, cg.output);
                   out.close();
                } catch (...) {
                   llvm::outs() << "Failed to create temporary file\n";
@@ -228,7 +228,7 @@ struct generation_utils {
    }
 
    std::string _translate_type( const std::string& t ) {
-      static std::map<std::string, std::string> translation_table =
+      static const std::map<std::string, std::string> translation_table =
       {
          {"unsigned __int128", "uint128"},
          {"__int128", "int128"},
@@ -266,6 +266,9 @@ struct generation_utils {
          {"unsigned_int", "varuint32"},
          {"signed_int",   "varint32"},
 
+         {"string_view", "string"},
+         {"bytes_view",  "bytes"},
+
          {"block_timestamp", "block_timestamp_type"},
          {"capi_name",    "name"},
          {"capi_public_key", "public_key"},
@@ -278,11 +281,11 @@ struct generation_utils {
          {"fixed_bytes_64", "checksum512"}
       };
       
-      auto ret = translation_table[t];
+      auto ret = translation_table.find(t);
 
-      if (ret == "")
+      if (ret == translation_table.end())
          return t;
-      return ret;
+      return ret->second;
    }
 
    inline std::string replace_in_name( std::string name ) {
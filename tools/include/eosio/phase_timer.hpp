@@ -0,0 +1,42 @@
+#pragma once
+
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   // Wall time of the compilation and link phases, printed with -ftime-phases
+   class phase_timer {
+      public:
+         using clock = std::chrono::steady_clock;
+
+         void record(const std::string& phase, clock::time_point start) {
+            add(phase, std::chrono::duration<double, std::milli>(clock::now() - start).count());
+         }
+
+         void add(const std::string& phase, double ms) {
+            std::lock_guard<std::mutex> lock(mutex);
+            phases.emplace_back(phase, ms);
+         }
+
+         void report(llvm::raw_ostream& os)const {
+            for (const auto& p : phases)
+               os << llvm::format("%10.1f ms  ", p.second) << p.first << "\n";
+            // phases of different inputs overlap with -j, so the total is the elapsed time
+            auto total = std::chrono::duration<double, std::milli>(clock::now() - started).count();
+            os << llvm::format("%10.1f ms  ", total) << "total\n";
+         }
+
+      private:
+         clock::time_point started = clock::now();
+         std::mutex mutex;
+         std::vector<std::pair<std::string, double>> phases;
+   };
+
+}} // ns eosio::cdt
@@ -2,7 +2,12 @@
 
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Program.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/raw_ostream.h"
 #include <stdlib.h>
 #if defined(__APPLE__)
 # include <crt_externs.h>
@@ -133,18 +138,32 @@ struct environment {
        }
      return env_table;
    }
+   // Runs the program without a shell and waits for it, returns false if it can't be run or exits with an error
    static bool exec_subprogram(const std::string prog, std::vector<std::string> options, bool root=false) {
-      std::stringstream args;
-      for (auto s : options)
-         args << s << " ";
       std::string find_path = eosio::cdt::whereami::where();
       if (root)
          find_path = "/usr/bin";
-      if ( auto path = llvm::sys::findProgramByName(prog.c_str(), {find_path}) )
-         std::system((*path+" "+args.str()).c_str());
-      else
+      auto path = llvm::sys::findProgramByName(prog.c_str(), {find_path});
+      if (!path)
          return false;
-      return true; 
+
+      // an option can hold several arguments with shell quoting, e.g. "-o file" or "--only-export \"*:table\""
+      llvm::BumpPtrAllocator alloc;
+      llvm::StringSaver saver(alloc);
+      llvm::SmallVector<const char*, 64> tokens;
+      for (const auto& opt : options)
+         llvm::cl::TokenizeGNUCommandLine(opt, saver, tokens);
+
+      std::vector<llvm::StringRef> args;
+      args.push_back(*path);
+      for (auto token : tokens)
+         args.push_back(token);
+
+      std::string err;
+      int ret = llvm::sys::ExecuteAndWait(*path, args, llvm::None, {}, 0, 0, &err);
+      if (!err.empty())
+         llvm::errs() << prog << ": " << err << "\n";
+      return ret == 0;
    }
 
 };
@@ -0,0 +1,227 @@
+#include "host.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+// Benchmark driver of a contract compiled by wasm2c (see add_wasm2c_benchmark in CyberwayCDTMacros.cmake).
+// It runs the actions of a payload file for a number of rounds and reports the time of each action.
+//
+// A payload line is `receiver code action hex-data`, `#` starts a comment.
+// Each round starts with empty tables, each action runs in a newly initialized module, as on the chain.
+// Only the apply() call is timed.
+
+// exports of the generated code
+extern "C" {
+   void init(void);
+   extern void (*Z_applyZ_vjjj)(uint64_t, uint64_t, uint64_t);
+}
+
+using namespace eosio::wasm2c;
+using eosio::native::chaindb_emulator;
+
+namespace {
+   struct payload_action {
+      std::string       line;
+      uint64_t          receiver;
+      uint64_t          code;
+      uint64_t          action;
+      std::vector<char> data;
+
+      std::vector<double> times;  // microseconds
+      uint32_t            failures = 0;
+      std::string         error;
+   };
+
+   bool from_hex(const std::string& hex, std::vector<char>& data) {
+      if (hex.size() % 2)
+         return false;
+      auto digit = [](char c) -> int {
+         if (c >= '0' && c <= '9') return c - '0';
+         if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+         if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+         return -1;
+      };
+      for (size_t i = 0; i < hex.size(); i += 2) {
+         const int hi = digit(hex[i]), lo = digit(hex[i+1]);
+         if (hi < 0 || lo < 0)
+            return false;
+         data.push_back(char(hi << 4 | lo));
+      }
+      return true;
+   }
+
+   bool read_file(const std::string& fn, std::string& content) {
+      std::ifstream in(fn, std::ios::binary);
+      if (!in)
+         return false;
+      std::stringstream ss;
+      ss << in.rdbuf();
+      content = ss.str();
+      return true;
+   }
+
+   bool read_payload(const std::string& fn, std::vector<payload_action>& actions) {
+      std::string content;
+      if (!read_file(fn, content)) {
+         fprintf(stderr, "error: unable to read %s\n", fn.c_str());
+         return false;
+      }
+      std::istringstream in(content);
+      std::string line;
+      for (int n = 1; std::getline(in, line); ++n) {
+         line = line.substr(0, line.find('#'));
+         std::istringstream fields(line);
+         std::string receiver, code, action, hex;
+         if (!(fields >> receiver))
+            continue;
+         payload_action act;
+         if (!(fields >> code >> action) || ((fields >> hex), !from_hex(hex, act.data))) {
+            fprintf(stderr, "error: %s:%d: expected `receiver code action hex-data`\n", fn.c_str(), n);
+            return false;
+         }
+         act.line = receiver + " " + code + " " + action;
+         act.receiver = chaindb_emulator::string_to_name(receiver);
+         act.code = chaindb_emulator::string_to_name(code);
+         act.action = chaindb_emulator::string_to_name(action);
+         actions.push_back(std::move(act));
+      }
+      return true;
+   }
+
+   // runs the action, returns its time in microseconds
+   double run(payload_action& act, uint64_t current_time, bool record) {
+      auto& st = state();
+      st.receiver = act.receiver;
+      st.code = act.code;
+      st.action = act.action;
+      st.action_data = act.data;
+      st.current_time = current_time;
+      reset_runtime();
+      init();
+
+      const auto start = std::chrono::steady_clock::now();
+      try {
+         Z_applyZ_vjjj(act.receiver, act.code, act.action);
+      } catch (const wasm_exit&) {
+      } catch (const wasm_error& e) {
+         if (record) {
+            ++act.failures;
+            if (act.error.empty())
+               act.error = e.what();
+         }
+         if (st.verbose)
+            fprintf(stderr, "%s: %s\n", act.line.c_str(), e.what());
+      }
+      const auto stop = std::chrono::steady_clock::now();
+      return std::chrono::duration<double, std::micro>(stop - start).count();
+   }
+
+   double percentile(const std::vector<double>& sorted, double p) {
+      if (sorted.empty())
+         return 0;
+      const size_t i = std::min(sorted.size() - 1, size_t(p / 100 * sorted.size()));
+      return sorted[i];
+   }
+
+   void usage(const char* name) {
+      fprintf(stderr,
+         "usage: %s [options] <payload>\n"
+         "  -n <rounds>   number of timed rounds (default 100)\n"
+         "  -w <rounds>   number of warm-up rounds (default 10)\n"
+         "  --abi <file>  ABI of the contract, the secondary indexes of its tables are built from it\n"
+         "  -v            print the output of the contract and the failed actions\n"
+         "A payload line is `receiver code action hex-data`, each round runs all the actions in a clean database.\n",
+         name);
+   }
+}
+
+int main(int argc, char** argv) {
+   int rounds = 100;
+   int warmup = 10;
+   std::string abi_file, payload_file;
+   for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if ((arg == "-n" || arg == "-w" || arg == "--abi") && i + 1 < argc) {
+         const char* value = argv[++i];
+         if (arg == "-n")
+            rounds = std::max(1, atoi(value));
+         else if (arg == "-w")
+            warmup = std::max(0, atoi(value));
+         else
+            abi_file = value;
+      } else if (arg == "-v") {
+         state().verbose = true;
+      } else if (arg == "-h" || arg == "--help") {
+         usage(argv[0]);
+         return 0;
+      } else if (payload_file.empty() && arg[0] != '-') {
+         payload_file = arg;
+      } else {
+         usage(argv[0]);
+         return 1;
+      }
+   }
+   if (payload_file.empty()) {
+      usage(argv[0]);
+      return 1;
+   }
+
+   std::vector<payload_action> actions;
+   if (!read_payload(payload_file, actions))
+      return 1;
+   if (actions.empty()) {
+      fprintf(stderr, "error: no actions in %s\n", payload_file.c_str());
+      return 1;
+   }
+
+   auto& st = state();
+   if (!abi_file.empty()) {
+      std::string abi;
+      if (!read_file(abi_file, abi)) {
+         fprintf(stderr, "error: unable to read %s\n", abi_file.c_str());
+         return 1;
+      }
+      for (const auto& act: actions) {
+         if (!st.chaindb.load_abi(act.receiver, abi.data(), abi.size())) {
+            fprintf(stderr, "error: unable to parse the ABI %s\n", abi_file.c_str());
+            return 1;
+         }
+      }
+   }
+
+   // the time of the chain is the same in every round, so rounds run the same code
+   const uint64_t start_time = 1577836800000000ull;
+   double total = 0;
+   for (int round = -warmup; round < rounds; ++round) {
+      if (round == 0)
+         st.inline_actions = st.deferred_transactions = 0;
+      st.chaindb.clear();
+      for (size_t i = 0; i < actions.size(); ++i) {
+         const double us = run(actions[i], start_time + i * 500000, round >= 0);
+         if (round >= 0) {
+            actions[i].times.push_back(us);
+            total += us;
+         }
+      }
+   }
+
+   printf("%-40s %10s %10s %10s %8s\n", "action", "min, us", "median", "p99", "failed");
+   uint32_t failures = 0;
+   for (auto& act: actions) {
+      failures += act.failures;
+      std::sort(act.times.begin(), act.times.end());
+      printf("%-40s %10.2f %10.2f %10.2f %8u\n", act.line.c_str(),
+         act.times.front(), percentile(act.times, 50), percentile(act.times, 99), act.failures);
+      if (!act.error.empty())
+         printf("   %s\n", act.error.c_str());
+   }
+   printf("%d rounds of %zu actions: %.0f actions/s\n", rounds, actions.size(),
+      total > 0 ? rounds * actions.size() / (total / 1e6) : 0.);
+   printf("inline actions: %u, deferred transactions: %u (not executed)\n",
+      st.inline_actions, st.deferred_transactions);
+   return failures > 0 ? 1 : 0;
+}
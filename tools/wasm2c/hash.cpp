@@ -0,0 +1,232 @@
+#include "host.hpp"
+
+#include <cstring>
+
+// Plain implementations of the hashes of the crypto intrinsics, the host has no crypto library.
+
+namespace eosio { namespace wasm2c {
+
+   namespace {
+      inline uint32_t rotl32(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+      inline uint32_t rotr32(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+      inline uint64_t rotr64(uint64_t x, int n) { return (x >> n) | (x << (64 - n)); }
+
+      inline uint32_t load_be32(const uint8_t* p) {
+         return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+      }
+
+      inline uint64_t load_be64(const uint8_t* p) {
+         return uint64_t(load_be32(p)) << 32 | load_be32(p + 4);
+      }
+
+      inline uint32_t load_le32(const uint8_t* p) {
+         return uint32_t(p[3]) << 24 | uint32_t(p[2]) << 16 | uint32_t(p[1]) << 8 | p[0];
+      }
+
+      inline void store_be32(uint8_t* p, uint32_t v) {
+         for (int i = 0; i < 4; ++i)
+            p[i] = uint8_t(v >> (24 - 8 * i));
+      }
+
+      inline void store_be64(uint8_t* p, uint64_t v) {
+         store_be32(p, uint32_t(v >> 32));
+         store_be32(p + 4, uint32_t(v));
+      }
+
+      inline void store_le32(uint8_t* p, uint32_t v) {
+         for (int i = 0; i < 4; ++i)
+            p[i] = uint8_t(v >> (8 * i));
+      }
+
+      // Merkle–Damgård padding: 0x80, zeros and the bit length in the last `length_size` bytes of the block
+      template<size_t BlockSize, size_t LengthSize, bool BigEndian, typename Compress>
+      void md_hash(const char* data, size_t size, Compress&& compress) {
+         const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+         size_t left = size;
+         for (; left >= BlockSize; left -= BlockSize, p += BlockSize)
+            compress(p);
+
+         uint8_t block[BlockSize * 2] = {};
+         memcpy(block, p, left);
+         block[left] = 0x80;
+         const size_t blocks = left + 1 + LengthSize > BlockSize ? 2 : 1;
+         const uint64_t bits = uint64_t(size) * 8;
+         uint8_t* length = block + blocks * BlockSize - (BigEndian ? 8 : LengthSize);
+         for (int i = 0; i < 8; ++i)
+            length[i] = uint8_t(BigEndian ? bits >> (56 - 8 * i) : bits >> (8 * i));
+         for (size_t i = 0; i < blocks; ++i)
+            compress(block + i * BlockSize);
+      }
+   }
+
+   void sha1(const char* data, size_t size, uint8_t (&hash)[20]) {
+      uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+      md_hash<64, 8, true>(data, size, [&](const uint8_t* block) {
+         uint32_t w[80];
+         for (int i = 0; i < 16; ++i)
+            w[i] = load_be32(block + 4 * i);
+         for (int i = 16; i < 80; ++i)
+            w[i] = rotl32(w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16], 1);
+         uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+         for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5a827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ed9eba1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8f1bbcdc; }
+            else             { f = b ^ c ^ d;                   k = 0xca62c1d6; }
+            const uint32_t t = rotl32(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rotl32(b, 30); b = a; a = t;
+         }
+         h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+      });
+      for (int i = 0; i < 5; ++i)
+         store_be32(hash + 4 * i, h[i]);
+   }
+
+   void sha256(const char* data, size_t size, uint8_t (&hash)[32]) {
+      static const uint32_t k[64] = {
+         0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+         0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+         0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+         0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+         0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+         0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+         0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+         0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+      };
+      uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+      md_hash<64, 8, true>(data, size, [&](const uint8_t* block) {
+         uint32_t w[64];
+         for (int i = 0; i < 16; ++i)
+            w[i] = load_be32(block + 4 * i);
+         for (int i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr32(w[i-15], 7) ^ rotr32(w[i-15], 18) ^ (w[i-15] >> 3);
+            const uint32_t s1 = rotr32(w[i-2], 17) ^ rotr32(w[i-2], 19) ^ (w[i-2] >> 10);
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+         }
+         uint32_t v[8];
+         memcpy(v, h, sizeof(v));
+         for (int i = 0; i < 64; ++i) {
+            const uint32_t s1 = rotr32(v[4], 6) ^ rotr32(v[4], 11) ^ rotr32(v[4], 25);
+            const uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+            const uint32_t t1 = v[7] + s1 + ch + k[i] + w[i];
+            const uint32_t s0 = rotr32(v[0], 2) ^ rotr32(v[0], 13) ^ rotr32(v[0], 22);
+            const uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+            memmove(v + 1, v, 7 * sizeof(uint32_t));
+            v[4] += t1;
+            v[0] = t1 + s0 + maj;
+         }
+         for (int i = 0; i < 8; ++i)
+            h[i] += v[i];
+      });
+      for (int i = 0; i < 8; ++i)
+         store_be32(hash + 4 * i, h[i]);
+   }
+
+   void sha512(const char* data, size_t size, uint8_t (&hash)[64]) {
+      static const uint64_t k[80] = {
+         0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538,
+         0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242, 0x12835b0145706fbe,
+         0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+         0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+         0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5, 0x983e5152ee66dfab,
+         0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+         0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed,
+         0x53380d139d95b3df, 0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+         0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+         0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8, 0x19a4c116b8d2d0c8, 0x1e376c085141ab53,
+         0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373,
+         0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+         0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b, 0xca273eceea26619c,
+         0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba, 0x0a637dc5a2c898a6,
+         0x113f9804bef90dae, 0x1b710b35131c471b, 0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+         0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+      };
+      uint64_t h[8] = {0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+                       0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+      md_hash<128, 16, true>(data, size, [&](const uint8_t* block) {
+         uint64_t w[80];
+         for (int i = 0; i < 16; ++i)
+            w[i] = load_be64(block + 8 * i);
+         for (int i = 16; i < 80; ++i) {
+            const uint64_t s0 = rotr64(w[i-15], 1) ^ rotr64(w[i-15], 8) ^ (w[i-15] >> 7);
+            const uint64_t s1 = rotr64(w[i-2], 19) ^ rotr64(w[i-2], 61) ^ (w[i-2] >> 6);
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+         }
+         uint64_t v[8];
+         memcpy(v, h, sizeof(v));
+         for (int i = 0; i < 80; ++i) {
+            const uint64_t s1 = rotr64(v[4], 14) ^ rotr64(v[4], 18) ^ rotr64(v[4], 41);
+            const uint64_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+            const uint64_t t1 = v[7] + s1 + ch + k[i] + w[i];
+            const uint64_t s0 = rotr64(v[0], 28) ^ rotr64(v[0], 34) ^ rotr64(v[0], 39);
+            const uint64_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+            memmove(v + 1, v, 7 * sizeof(uint64_t));
+            v[4] += t1;
+            v[0] = t1 + s0 + maj;
+         }
+         for (int i = 0; i < 8; ++i)
+            h[i] += v[i];
+      });
+      for (int i = 0; i < 8; ++i)
+         store_be64(hash + 8 * i, h[i]);
+   }
+
+   void ripemd160(const char* data, size_t size, uint8_t (&hash)[20]) {
+      static const int r1[80] = {
+         0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,   7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+         3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,   1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+         4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13,
+      };
+      static const int r2[80] = {
+         5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,   6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+         15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,   8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+         12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11,
+      };
+      static const int s1[80] = {
+         11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,   7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+         11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,   11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+         9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6,
+      };
+      static const int s2[80] = {
+         8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,   9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+         9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,   15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+         8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11,
+      };
+      static const uint32_t k1[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+      static const uint32_t k2[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+      auto f = [](int j, uint32_t x, uint32_t y, uint32_t z) -> uint32_t {
+         switch (j / 16) {
+            case 0:  return x ^ y ^ z;
+            case 1:  return (x & y) | (~x & z);
+            case 2:  return (x | ~y) ^ z;
+            case 3:  return (x & z) | (y & ~z);
+            default: return x ^ (y | ~z);
+         }
+      };
+
+      uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+      md_hash<64, 8, false>(data, size, [&](const uint8_t* block) {
+         uint32_t x[16];
+         for (int i = 0; i < 16; ++i)
+            x[i] = load_le32(block + 4 * i);
+         uint32_t a1 = h[0], b1 = h[1], c1 = h[2], d1 = h[3], e1 = h[4];
+         uint32_t a2 = h[0], b2 = h[1], c2 = h[2], d2 = h[3], e2 = h[4];
+         for (int j = 0; j < 80; ++j) {
+            uint32_t t = rotl32(a1 + f(j, b1, c1, d1) + x[r1[j]] + k1[j / 16], s1[j]) + e1;
+            a1 = e1; e1 = d1; d1 = rotl32(c1, 10); c1 = b1; b1 = t;
+            t = rotl32(a2 + f(79 - j, b2, c2, d2) + x[r2[j]] + k2[j / 16], s2[j]) + e2;
+            a2 = e2; e2 = d2; d2 = rotl32(c2, 10); c2 = b2; b2 = t;
+         }
+         const uint32_t t = h[1] + c1 + d2;
+         h[1] = h[2] + d1 + e2;
+         h[2] = h[3] + e1 + a2;
+         h[3] = h[4] + a1 + b2;
+         h[4] = h[0] + b1 + c2;
+         h[0] = t;
+      });
+      for (int i = 0; i < 5; ++i)
+         store_le32(hash + 4 * i, h[i]);
+   }
+
+}} // ns eosio::wasm2c
@@ -0,0 +1,468 @@
+#include "host.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+// The intrinsics of contracts compiled by wasm2c.
+// Imports of the generated code are the function pointers Z_<module>Z_<field>Z_<signature>,
+// where the signature is the result type and the parameter types (i32 'i', i64 'j', f32 'f', f64 'd', none 'v').
+// Pointers of the contract are offsets in its linear memory, the accesses are bounds checked.
+//
+// The host runs one contract: authorizations pass, sent actions and transactions are counted and not executed.
+
+namespace eosio { namespace wasm2c {
+
+   static void fail_chaindb(const char* msg) {
+      fail(msg);
+   }
+
+   host_state::host_state() : chaindb(&fail_chaindb) {}
+
+   host_state& state() {
+      static host_state st;
+      return st;
+   }
+
+namespace intrinsics {
+
+   using u32 = uint32_t;
+   using u64 = uint64_t;
+   using f32 = float;
+   using f64 = double;
+
+   static char* ptr(u32 offset, u64 size) {
+      auto mem = state().memory;
+      if (!mem || uint64_t(offset) + size > mem->size)
+         fail("access violation");
+      return reinterpret_cast<char*>(mem->data) + offset;
+   }
+
+   static const char* cstr(u32 offset) {
+      auto mem = state().memory;
+      if (!mem || offset >= mem->size || !memchr(mem->data + offset, 0, mem->size - offset))
+         fail("access violation");
+      return reinterpret_cast<const char*>(mem->data) + offset;
+   }
+
+   template<typename T>
+   static T load(u32 offset) {
+      T value;
+      memcpy(&value, ptr(offset, sizeof(T)), sizeof(T));
+      return value;
+   }
+
+   template<typename T>
+   static void store(u32 offset, const T& value) {
+      memcpy(ptr(offset, sizeof(T)), &value, sizeof(T));
+   }
+
+   static std::string name_to_string(u64 value) {
+      static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+      std::string str(13, '.');
+      u64 tmp = value;
+      for (int i = 0; i <= 12; ++i) {
+         const char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+         str[12 - i] = c;
+         tmp >>= (i == 0 ? 4 : 5);
+      }
+      const auto last = str.find_last_not_of('.');
+      return last == std::string::npos ? std::string() : str.substr(0, last + 1);
+   }
+
+   static void print(const char* data, size_t size) {
+      if (state().verbose)
+         fwrite(data, 1, size, stdout);
+   }
+
+   static void print(const std::string& str) {
+      print(str.data(), str.size());
+   }
+
+   // action.h
+   static u32 read_action_data(u32 msg, u32 len) {
+      const auto& data = state().action_data;
+      if (len == 0)
+         return data.size();
+      const u32 size = std::min<size_t>(len, data.size());
+      memcpy(ptr(msg, size), data.data(), size);
+      return size;
+   }
+   static u32 action_data_size() { return state().action_data.size(); }
+   static void require_recipient(u64) {}
+   static void require_auth(u64) {}
+   static u32 weak_require_auth(u64) { return 1; }
+   static u32 has_auth(u64) { return 1; }
+   static void require_auth2(u64, u64) {}
+   static u32 weak_require_auth2(u64, u64) { return 1; }
+   static u32 is_account(u64) { return 1; }
+   static void send_inline(u32 data, u32 size) { ptr(data, size); ++state().inline_actions; }
+   static void send_context_free_inline(u32 data, u32 size) { ptr(data, size); ++state().inline_actions; }
+   static u64 publication_time() { return state().current_time; }
+   static u64 current_receiver() { return state().receiver; }
+   static u32 get_active_producers(u32, u32) { return 0; }
+
+   // print.h
+   static void prints(u32 str) { print(cstr(str), strlen(cstr(str))); }
+   static void prints_l(u32 str, u32 len) { print(ptr(str, len), len); }
+   static void printi(u64 value) { print(std::to_string(int64_t(value))); }
+   static void printui(u64 value) { print(std::to_string(value)); }
+   static void printi128(u32 value) {
+      const auto v = load<__int128>(value);
+      const bool negative = v < 0;
+      unsigned __int128 u = negative ? -static_cast<unsigned __int128>(v) : v;
+      std::string str;
+      do { str.insert(str.begin(), char('0' + u % 10)); u /= 10; } while (u);
+      print((negative ? "-" : "") + str);
+   }
+   static void printui128(u32 value) {
+      auto u = load<unsigned __int128>(value);
+      std::string str;
+      do { str.insert(str.begin(), char('0' + u % 10)); u /= 10; } while (u);
+      print(str);
+   }
+   static void printsf(f32 value) {
+      char buf[32];
+      print(buf, snprintf(buf, sizeof(buf), "%.*e", 8, double(value)));
+   }
+   static void printdf(f64 value) {
+      char buf[32];
+      print(buf, snprintf(buf, sizeof(buf), "%.*e", 16, value));
+   }
+   static void printqf(u32 value) {
+      ptr(value, 16);
+      print("<float128>");
+   }
+   static void printn(u64 value) { print(name_to_string(value)); }
+   static void printhex(u32 data, u32 len) {
+      const char* bytes = ptr(data, len);
+      std::string str;
+      for (u32 i = 0; i < len; ++i) {
+         char buf[3];
+         snprintf(buf, sizeof(buf), "%02x", uint8_t(bytes[i]));
+         str += buf;
+      }
+      print(str);
+   }
+
+   // system.h
+   static void eosio_assert(u32 test, u32 msg) {
+      if (!test)
+         fail(std::string("assertion failure with message: ") + cstr(msg));
+   }
+   static void eosio_assert_message(u32 test, u32 msg, u32 len) {
+      if (!test)
+         fail("assertion failure with message: " + std::string(ptr(msg, len), len));
+   }
+   static void eosio_assert_code(u32 test, u64 code) {
+      if (!test)
+         fail("assertion failure with error code: " + std::to_string(code));
+   }
+   static void eosio_exit(u32) { throw wasm_exit(); }
+   static u64 current_time() { return state().current_time; }
+
+   // crypto.h
+   template<size_t N, void (*Hash)(const char*, size_t, uint8_t (&)[N])>
+   static void hash(u32 data, u32 len, u32 out) {
+      uint8_t result[N];
+      Hash(ptr(data, len), len, result);
+      memcpy(ptr(out, N), result, N);
+   }
+   template<size_t N, void (*Hash)(const char*, size_t, uint8_t (&)[N])>
+   static void assert_hash(u32 data, u32 len, u32 expected) {
+      uint8_t result[N];
+      Hash(ptr(data, len), len, result);
+      if (memcmp(ptr(expected, N), result, N))
+         fail("hash mismatch");
+   }
+   static u32 recover_key(u32, u32, u32, u32, u32) { fail("recover_key is not supported by the wasm2c host"); }
+   static void assert_recover_key(u32, u32, u32, u32, u32) { fail("assert_recover_key is not supported by the wasm2c host"); }
+
+   // transaction.h
+   static void send_deferred(u32 sender_id, u64, u32 data, u32 size, u32) {
+      ptr(sender_id, 16);
+      ptr(data, size);
+      ++state().deferred_transactions;
+   }
+   static u32 cancel_deferred(u32 sender_id) { ptr(sender_id, 16); return 0; }
+   static void send_nested(u32 data, u32 size) { ptr(data, size); ++state().deferred_transactions; }
+   static u32 read_transaction(u32, u32) { return 0; }
+   static u32 transaction_size() { return 0; }
+   static u32 tapos_block_num() { return 0; }
+   static u32 tapos_block_prefix() { return 0; }
+   static u32 expiration() { return 0; }
+   static u32 get_action(u32, u32, u32, u32) { return -1; }
+   static u32 get_context_free_data(u32, u32, u32) { return -1; }
+
+   // permission.h
+   static u32 check_transaction_authorization(u32, u32, u32, u32, u32, u32) { return 1; }
+   static u32 check_permission_authorization(u64, u64, u32, u32, u32, u32, u64) { return 1; }
+   static u64 get_permission_last_used(u64, u64) { return 0; }
+   static u64 get_account_creation_time(u64) { return 0; }
+
+   // privileged.h
+   static u64 set_proposed_producers(u32, u32) { return -1; }
+   static u32 is_privileged(u64) { return 0; }
+   static void set_blockchain_parameters_packed(u32 data, u32 len) { ptr(data, len); }
+   static u32 get_blockchain_parameters_packed(u32, u32) { return 0; }
+   static void update_stake_proxied(u64, u64, u32) {}
+   static void recall_stake_proxied(u64, u64, u64, u32) {}
+   static u64 get_used_resources_cost(u64) { return 0; }
+
+   // domain.h and event.h
+   static u32 is_domain(u32 domain) { cstr(domain); return 0; }
+   static u32 is_username(u64, u32 username) { cstr(username); return 0; }
+   static u64 get_domain_owner(u32) { fail("domains are not supported by the wasm2c host"); }
+   static u64 resolve_domain(u32) { fail("domains are not supported by the wasm2c host"); }
+   static u64 resolve_username(u64, u32) { fail("domains are not supported by the wasm2c host"); }
+   static void send_event(u32 data, u32 size) { ptr(data, size); }
+
+   // chaindb.h
+   static u32 chaindb_begin(u64 code, u64 scope, u64 table, u64 index) {
+      return state().chaindb.begin(code, scope, table, index);
+   }
+   static u32 chaindb_end(u64 code, u64 scope, u64 table, u64 index) {
+      return state().chaindb.end(code, scope, table, index);
+   }
+   static u32 chaindb_lower_bound(u64 code, u64 scope, u64 table, u64 index, u32 key, u32 size) {
+      return state().chaindb.lower_bound(code, scope, table, index, ptr(key, size), size);
+   }
+   static u32 chaindb_lower_bound_pk(u64 code, u64 scope, u64 table, u64 pk) {
+      return state().chaindb.lower_bound_pk(code, scope, table, pk);
+   }
+   static u32 chaindb_upper_bound(u64 code, u64 scope, u64 table, u64 index, u32 key, u32 size) {
+      return state().chaindb.upper_bound(code, scope, table, index, ptr(key, size), size);
+   }
+   static u32 chaindb_upper_bound_pk(u64 code, u64 scope, u64 table, u64 pk) {
+      return state().chaindb.upper_bound_pk(code, scope, table, pk);
+   }
+   static u32 chaindb_locate_to(u64 code, u64 scope, u64 table, u64 index, u64 pk, u32 key, u32 size) {
+      ptr(key, size);
+      return state().chaindb.locate_to(code, scope, table, index, pk);
+   }
+   static u32 chaindb_clone(u64, u32 cursor) { return state().chaindb.clone(cursor); }
+   static void chaindb_close(u64, u32 cursor) { state().chaindb.close(cursor); }
+   static u64 chaindb_current(u64, u32 cursor) { return state().chaindb.current(cursor); }
+   static u64 chaindb_next(u64, u32 cursor) { return state().chaindb.next(cursor); }
+   static u64 chaindb_prev(u64, u32 cursor) { return state().chaindb.prev(cursor); }
+   static u32 chaindb_datasize(u64, u32 cursor) { return state().chaindb.datasize(cursor); }
+   static u64 chaindb_data(u64, u32 cursor, u32 data, u32 size) {
+      return state().chaindb.data(cursor, ptr(data, size), size);
+   }
+   static u32 chaindb_service(u64, u32 cursor, u32 data, u32 size) {
+      return state().chaindb.service(cursor, ptr(data, size), size);
+   }
+   static u32 chaindb_fetch(u64, u32 cursor, u32 count, u32 data, u32 size) {
+      return state().chaindb.fetch(cursor, count, ptr(data, size), size);
+   }
+   static u64 chaindb_available_primary_key(u64 code, u64 scope, u64 table) {
+      return state().chaindb.available_primary_key(code, scope, table);
+   }
+   static u32 chaindb_insert(u64 code, u64 scope, u64 table, u64 payer, u64 pk, u32 data, u32 size) {
+      return state().chaindb.insert(code, scope, table, payer, pk, ptr(data, size), size);
+   }
+   static u32 chaindb_update(u64 code, u64 scope, u64 table, u64 payer, u64 pk, u32 data, u32 size) {
+      return state().chaindb.update(code, scope, table, payer, pk, ptr(data, size), size);
+   }
+   static u32 chaindb_delete(u64 code, u64 scope, u64 table, u64, u64 pk) {
+      return state().chaindb.remove(code, scope, table, pk);
+   }
+   static void chaindb_ram_state(u64 code, u64 scope, u64 table, u64 pk, u32 in_ram) {
+      state().chaindb.ram_state(code, scope, table, pk, in_ram);
+   }
+
+   // compiler-rt helpers of 128-bit integers, the result is written to `ret`
+   using i128 = __int128;
+   using u128 = unsigned __int128;
+
+   static i128 make128(u64 lo, u64 hi) { return i128((u128(hi) << 64) | lo); }
+
+   static void store128(u32 ret, i128 value) {
+      store<u64>(ret, u64(u128(value)));
+      store<u64>(ret + 8, u64(u128(value) >> 64));
+   }
+
+   static void ashlti3(u32 ret, u64 lo, u64 hi, u32 shift) {
+      store128(ret, shift >= 128 ? 0 : i128(u128(make128(lo, hi)) << shift));
+   }
+   static void ashrti3(u32 ret, u64 lo, u64 hi, u32 shift) {
+      const i128 v = make128(lo, hi);
+      store128(ret, shift >= 128 ? (v < 0 ? -1 : 0) : v >> shift);
+   }
+   static void lshlti3(u32 ret, u64 lo, u64 hi, u32 shift) { ashlti3(ret, lo, hi, shift); }
+   static void lshrti3(u32 ret, u64 lo, u64 hi, u32 shift) {
+      store128(ret, shift >= 128 ? 0 : i128(u128(make128(lo, hi)) >> shift));
+   }
+   static void divti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+      const i128 a = make128(la, ha), b = make128(lb, hb);
+      if (!b)
+         fail("divide by zero");
+      if (b == -1 && a == i128(u128(1) << 127))
+         fail("integer overflow");
+      store128(ret, a / b);
+   }
+   static void udivti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+      const u128 a = u128(make128(la, ha)), b = u128(make128(lb, hb));
+      if (!b)
+         fail("divide by zero");
+      store128(ret, i128(a / b));
+   }
+   static void modti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+      const i128 a = make128(la, ha), b = make128(lb, hb);
+      if (!b)
+         fail("divide by zero");
+      store128(ret, b == -1 ? 0 : a % b);
+   }
+   static void umodti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+      const u128 a = u128(make128(la, ha)), b = u128(make128(lb, hb));
+      if (!b)
+         fail("divide by zero");
+      store128(ret, i128(a % b));
+   }
+   static void multi3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+      store128(ret, i128(u128(make128(la, ha)) * u128(make128(lb, hb))));
+   }
+
+   // memory functions imported by contracts
+   static u32 memcpy_(u32 dest, u32 src, u32 size) {
+      char* d = ptr(dest, size);
+      const char* s = ptr(src, size);
+      if ((dest < src ? src - dest : dest - src) < size)
+         fail("memcpy can only accept non-aliasing pointers");
+      memcpy(d, s, size);
+      return dest;
+   }
+   static u32 memmove_(u32 dest, u32 src, u32 size) {
+      memmove(ptr(dest, size), ptr(src, size), size);
+      return dest;
+   }
+   static u32 memcmp_(u32 a, u32 b, u32 size) {
+      const int r = memcmp(ptr(a, size), ptr(b, size), size);
+      return r < 0 ? -1 : (r > 0 ? 1 : 0);
+   }
+   static u32 memset_(u32 dest, u32 value, u32 size) {
+      memset(ptr(dest, size), value, size);
+      return dest;
+   }
+   static void abort_() { fail("abort() called"); }
+
+} // ns intrinsics
+
+}} // ns eosio::wasm2c
+
+#define WASM2C_IMPORT(field, signature, ...) \
+   extern "C" { \
+      decltype(&eosio::wasm2c::intrinsics::__VA_ARGS__) Z_envZ_##field##Z_##signature = &eosio::wasm2c::intrinsics::__VA_ARGS__; \
+   }
+
+WASM2C_IMPORT(read_action_data, iii, read_action_data)
+WASM2C_IMPORT(action_data_size, iv, action_data_size)
+WASM2C_IMPORT(require_recipient, vj, require_recipient)
+WASM2C_IMPORT(require_auth, vj, require_auth)
+WASM2C_IMPORT(weak_require_auth, ij, weak_require_auth)
+WASM2C_IMPORT(has_auth, ij, has_auth)
+WASM2C_IMPORT(require_auth2, vjj, require_auth2)
+WASM2C_IMPORT(weak_require_auth2, ijj, weak_require_auth2)
+WASM2C_IMPORT(is_account, ij, is_account)
+WASM2C_IMPORT(send_inline, vii, send_inline)
+WASM2C_IMPORT(send_context_free_inline, vii, send_context_free_inline)
+WASM2C_IMPORT(publication_time, jv, publication_time)
+WASM2C_IMPORT(current_receiver, jv, current_receiver)
+WASM2C_IMPORT(get_active_producers, iii, get_active_producers)
+
+WASM2C_IMPORT(prints, vi, prints)
+WASM2C_IMPORT(prints_l, vii, prints_l)
+WASM2C_IMPORT(printi, vj, printi)
+WASM2C_IMPORT(printui, vj, printui)
+WASM2C_IMPORT(printi128, vi, printi128)
+WASM2C_IMPORT(printui128, vi, printui128)
+WASM2C_IMPORT(printsf, vf, printsf)
+WASM2C_IMPORT(printdf, vd, printdf)
+WASM2C_IMPORT(printqf, vi, printqf)
+WASM2C_IMPORT(printn, vj, printn)
+WASM2C_IMPORT(printhex, vii, printhex)
+
+WASM2C_IMPORT(eosio_assert, vii, eosio_assert)
+WASM2C_IMPORT(eosio_assert_message, viii, eosio_assert_message)
+WASM2C_IMPORT(eosio_assert_code, vij, eosio_assert_code)
+WASM2C_IMPORT(eosio_exit, vi, eosio_exit)
+WASM2C_IMPORT(current_time, jv, current_time)
+
+WASM2C_IMPORT(sha1, viii, hash<20, eosio::wasm2c::sha1>)
+WASM2C_IMPORT(sha256, viii, hash<32, eosio::wasm2c::sha256>)
+WASM2C_IMPORT(sha512, viii, hash<64, eosio::wasm2c::sha512>)
+WASM2C_IMPORT(ripemd160, viii, hash<20, eosio::wasm2c::ripemd160>)
+WASM2C_IMPORT(assert_sha1, viii, assert_hash<20, eosio::wasm2c::sha1>)
+WASM2C_IMPORT(assert_sha256, viii, assert_hash<32, eosio::wasm2c::sha256>)
+WASM2C_IMPORT(assert_sha512, viii, assert_hash<64, eosio::wasm2c::sha512>)
+WASM2C_IMPORT(assert_ripemd160, viii, assert_hash<20, eosio::wasm2c::ripemd160>)
+WASM2C_IMPORT(recover_key, iiiiii, recover_key)
+WASM2C_IMPORT(assert_recover_key, viiiii, assert_recover_key)
+
+WASM2C_IMPORT(send_deferred, vijiii, send_deferred)
+WASM2C_IMPORT(cancel_deferred, ii, cancel_deferred)
+WASM2C_IMPORT(send_nested, vii, send_nested)
+WASM2C_IMPORT(read_transaction, iii, read_transaction)
+WASM2C_IMPORT(transaction_size, iv, transaction_size)
+WASM2C_IMPORT(tapos_block_num, iv, tapos_block_num)
+WASM2C_IMPORT(tapos_block_prefix, iv, tapos_block_prefix)
+WASM2C_IMPORT(expiration, iv, expiration)
+WASM2C_IMPORT(get_action, iiiii, get_action)
+WASM2C_IMPORT(get_context_free_data, iiii, get_context_free_data)
+
+WASM2C_IMPORT(check_transaction_authorization, iiiiiii, check_transaction_authorization)
+WASM2C_IMPORT(check_permission_authorization, ijjiiiij, check_permission_authorization)
+WASM2C_IMPORT(get_permission_last_used, jjj, get_permission_last_used)
+WASM2C_IMPORT(get_account_creation_time, jj, get_account_creation_time)
+
+WASM2C_IMPORT(set_proposed_producers, jii, set_proposed_producers)
+WASM2C_IMPORT(is_privileged, ij, is_privileged)
+WASM2C_IMPORT(set_blockchain_parameters_packed, vii, set_blockchain_parameters_packed)
+WASM2C_IMPORT(get_blockchain_parameters_packed, iii, get_blockchain_parameters_packed)
+WASM2C_IMPORT(update_stake_proxied, vjji, update_stake_proxied)
+WASM2C_IMPORT(recall_stake_proxied, vjjji, recall_stake_proxied)
+WASM2C_IMPORT(get_used_resources_cost, jj, get_used_resources_cost)
+
+WASM2C_IMPORT(is_domain, ii, is_domain)
+WASM2C_IMPORT(is_username, iji, is_username)
+WASM2C_IMPORT(get_domain_owner, ji, get_domain_owner)
+WASM2C_IMPORT(resolve_domain, ji, resolve_domain)
+WASM2C_IMPORT(resolve_username, jji, resolve_username)
+WASM2C_IMPORT(send_event, vii, send_event)
+
+WASM2C_IMPORT(chaindb_begin, ijjjj, chaindb_begin)
+WASM2C_IMPORT(chaindb_end, ijjjj, chaindb_end)
+WASM2C_IMPORT(chaindb_lower_bound, ijjjjii, chaindb_lower_bound)
+WASM2C_IMPORT(chaindb_lower_bound_pk, ijjjj, chaindb_lower_bound_pk)
+WASM2C_IMPORT(chaindb_upper_bound, ijjjjii, chaindb_upper_bound)
+WASM2C_IMPORT(chaindb_upper_bound_pk, ijjjj, chaindb_upper_bound_pk)
+WASM2C_IMPORT(chaindb_locate_to, ijjjjjii, chaindb_locate_to)
+WASM2C_IMPORT(chaindb_clone, iji, chaindb_clone)
+WASM2C_IMPORT(chaindb_close, vji, chaindb_close)
+WASM2C_IMPORT(chaindb_current, jji, chaindb_current)
+WASM2C_IMPORT(chaindb_next, jji, chaindb_next)
+WASM2C_IMPORT(chaindb_prev, jji, chaindb_prev)
+WASM2C_IMPORT(chaindb_datasize, iji, chaindb_datasize)
+WASM2C_IMPORT(chaindb_data, jjiii, chaindb_data)
+WASM2C_IMPORT(chaindb_service, ijiii, chaindb_service)
+WASM2C_IMPORT(chaindb_fetch, ijiiii, chaindb_fetch)
+WASM2C_IMPORT(chaindb_available_primary_key, jjjj, chaindb_available_primary_key)
+WASM2C_IMPORT(chaindb_insert, ijjjjjii, chaindb_insert)
+WASM2C_IMPORT(chaindb_update, ijjjjjii, chaindb_update)
+WASM2C_IMPORT(chaindb_delete, ijjjjj, chaindb_delete)
+WASM2C_IMPORT(chaindb_ram_state, vjjjji, chaindb_ram_state)
+
+WASM2C_IMPORT(__ashlti3, vijji, ashlti3)
+WASM2C_IMPORT(__ashrti3, vijji, ashrti3)
+WASM2C_IMPORT(__lshlti3, vijji, lshlti3)
+WASM2C_IMPORT(__lshrti3, vijji, lshrti3)
+WASM2C_IMPORT(__divti3, vijjjj, divti3)
+WASM2C_IMPORT(__udivti3, vijjjj, udivti3)
+WASM2C_IMPORT(__modti3, vijjjj, modti3)
+WASM2C_IMPORT(__umodti3, vijjjj, umodti3)
+WASM2C_IMPORT(__multi3, vijjjj, multi3)
+
+WASM2C_IMPORT(memcpy, iiii, memcpy_)
+WASM2C_IMPORT(memmove, iiii, memmove_)
+WASM2C_IMPORT(memcmp, iiii, memcmp_)
+WASM2C_IMPORT(memset, iiii, memset_)
+WASM2C_IMPORT(abort, vv, abort_)
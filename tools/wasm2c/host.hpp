@@ -0,0 +1,61 @@
+#pragma once
+
+#include "wasm-rt.h"
+
+#include <eosio/chaindb_emulator.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace wasm2c {
+
+   // State of the host for the contract compiled by wasm2c.
+   // The generated code calls the intrinsics through the Z_env* pointers (see host.cpp)
+   // and the runtime functions wasm_rt_* (see runtime.cpp).
+   struct host_state {
+      // the linear memory of the module, contracts don't export it, so it is taken at the allocation
+      wasm_rt_memory_t* memory = nullptr;
+
+      uint64_t          receiver = 0;
+      uint64_t          code = 0;
+      uint64_t          action = 0;
+      std::vector<char> action_data;
+      uint64_t          current_time = 0;
+
+      native::chaindb_emulator chaindb;
+
+      bool              verbose = false;
+
+      // actions and transactions sent by the contract, they are not executed
+      uint32_t          inline_actions = 0;
+      uint32_t          deferred_transactions = 0;
+
+      host_state();
+   };
+
+   host_state& state();
+
+   // Traps and failed assertions are thrown through the generated code, it is compiled with -fexceptions
+   struct wasm_error : std::runtime_error {
+      using std::runtime_error::runtime_error;
+   };
+
+   // eosio_exit, the action is finished without an error
+   struct wasm_exit {};
+
+   [[noreturn]] inline void fail(const std::string& msg) {
+      throw wasm_error(msg);
+   }
+
+   /// Resets the runtime after a trap, the generated code doesn't unwind its call depth
+   void reset_runtime();
+
+   // hashes of the crypto intrinsics, see hash.cpp
+   void sha1(const char* data, size_t size, uint8_t (&hash)[20]);
+   void sha256(const char* data, size_t size, uint8_t (&hash)[32]);
+   void sha512(const char* data, size_t size, uint8_t (&hash)[64]);
+   void ripemd160(const char* data, size_t size, uint8_t (&hash)[20]);
+
+}} // ns eosio::wasm2c
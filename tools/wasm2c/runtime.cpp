@@ -0,0 +1,115 @@
+#include "host.hpp"
+
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+
+// The runtime of wasm2c, instead of wasm-rt-impl.c of wabt:
+// the module is initialized before each action, so the memory and the table reuse their buffers,
+// and traps jump back to the benchmark loop.
+
+static const uint32_t page_size = 65536;
+
+static const char* trap_message(wasm_rt_trap_t code) {
+   switch (code) {
+      case WASM_RT_TRAP_OOB:                return "wasm trap: out of bounds memory access";
+      case WASM_RT_TRAP_INT_OVERFLOW:       return "wasm trap: integer overflow";
+      case WASM_RT_TRAP_DIV_BY_ZERO:        return "wasm trap: integer divide by zero";
+      case WASM_RT_TRAP_INVALID_CONVERSION: return "wasm trap: invalid conversion to integer";
+      case WASM_RT_TRAP_UNREACHABLE:        return "wasm trap: unreachable";
+      case WASM_RT_TRAP_CALL_INDIRECT:      return "wasm trap: invalid call_indirect";
+      case WASM_RT_TRAP_EXHAUSTION:         return "wasm trap: call stack exhausted";
+      default:                              return "wasm trap";
+   }
+}
+
+namespace {
+   struct func_type {
+      std::vector<wasm_rt_type_t> params;
+      std::vector<wasm_rt_type_t> results;
+
+      bool operator == (const func_type& other) const {
+         return params == other.params && results == other.results;
+      }
+   };
+
+   std::vector<func_type>& func_types() {
+      static std::vector<func_type> types;
+      return types;
+   }
+}
+
+extern "C" {
+
+uint32_t wasm_rt_call_stack_depth = 0;
+
+void wasm_rt_trap(wasm_rt_trap_t code) {
+   eosio::wasm2c::fail(trap_message(code));
+}
+
+uint32_t wasm_rt_register_func_type(uint32_t params, uint32_t results, ...) {
+   func_type type;
+   va_list args;
+   va_start(args, results);
+   for (uint32_t i = 0; i < params; ++i)
+      type.params.push_back(static_cast<wasm_rt_type_t>(va_arg(args, int)));
+   for (uint32_t i = 0; i < results; ++i)
+      type.results.push_back(static_cast<wasm_rt_type_t>(va_arg(args, int)));
+   va_end(args);
+
+   auto& types = func_types();
+   for (size_t i = 0; i < types.size(); ++i) {
+      if (types[i] == type)
+         return i + 1;
+   }
+   types.push_back(std::move(type));
+   return types.size();
+}
+
+void wasm_rt_allocate_memory(wasm_rt_memory_t* memory, uint32_t initial_pages, uint32_t max_pages) {
+   const size_t size = size_t(initial_pages) * page_size;
+   // `data` is set if the module is initialized again
+   memory->data = static_cast<uint8_t*>(realloc(memory->data, size ? size : 1));
+   if (!memory->data)
+      abort();
+   memset(memory->data, 0, size);
+   memory->pages = initial_pages;
+   memory->max_pages = max_pages;
+   memory->size = size;
+   eosio::wasm2c::state().memory = memory;
+}
+
+uint32_t wasm_rt_grow_memory(wasm_rt_memory_t* memory, uint32_t delta) {
+   const uint32_t old_pages = memory->pages;
+   const uint32_t new_pages = old_pages + delta;
+   if (new_pages < old_pages || new_pages > memory->max_pages || new_pages > 65536)
+      return uint32_t(-1);
+   const size_t new_size = size_t(new_pages) * page_size;
+   auto data = static_cast<uint8_t*>(realloc(memory->data, new_size ? new_size : 1));
+   if (!data)
+      return uint32_t(-1);
+   memset(data + memory->size, 0, new_size - memory->size);
+   memory->data = data;
+   memory->pages = new_pages;
+   memory->size = new_size;
+   return old_pages;
+}
+
+void wasm_rt_allocate_table(wasm_rt_table_t* table, uint32_t elements, uint32_t max_elements) {
+   table->data = static_cast<wasm_rt_elem_t*>(realloc(table->data, (elements ? elements : 1) * sizeof(wasm_rt_elem_t)));
+   if (!table->data)
+      abort();
+   memset(table->data, 0, elements * sizeof(wasm_rt_elem_t));
+   table->size = elements;
+   table->max_size = max_elements;
+}
+
+} // extern "C"
+
+namespace eosio { namespace wasm2c {
+
+   void reset_runtime() {
+      wasm_rt_call_stack_depth = 0;
+   }
+
+}} // ns eosio::wasm2c